@@ -0,0 +1,296 @@
+// ----------------------------------------------------
+// Corrida de referencia ("golden run") del gestor
+//
+// Repite un guion de entrada grabado contra el programa con una semilla fija y
+// compara el estado final (HOSPITAL_RESUMEN) con el de la referencia. Además
+// falla si el tiempo o la memoria máxima (RSS) empeoran más que el umbral.
+//
+// Compilar desde la raíz del repositorio:
+//   gcc -O2 bench/golden.c -o golden
+//
+// Uso:
+//   ./golden --guion bench/golden/mes.txt [--programa ./gestor_hospital]
+//            [--referencia archivo.ref] [--semilla N] [--repeticiones N]
+//            [--umbral 0.20] [--holgura_ms 5] [--limite_s 60] [--actualizar]
+//
+// Los guiones .cmd se pasan con --comandos (lenguaje de comandos por IDs); los
+// demás son las teclas de los menús.
+//
+// Con --actualizar se reescribe la referencia con el resultado de la corrida.
+// Devuelve 0 si todo coincide, 1 si cambia el estado o hay una regresión y 2
+// ante errores de uso.
+// ----------------------------------------------------
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_RESUMEN (1 << 20)
+#define MAX_DIFERENCIAS 10
+
+typedef struct {
+    double tiempo_ms;
+    long rss_kb;
+    char* estado;          // resumen del estado final
+} Corrida;
+
+typedef struct {
+    unsigned semilla;
+    double tiempo_ms;
+    long rss_kb;
+    char* estado;
+} Referencia;
+
+static double ahora_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Lee un archivo completo; NULL si no existe
+static char* leer_archivo(const char* ruta) {
+    FILE* f = fopen(ruta, "r");
+    if (!f) return NULL;
+    char* texto = malloc(MAX_RESUMEN);
+    if (!texto) {
+        fclose(f);
+        return NULL;
+    }
+    size_t n = fread(texto, 1, MAX_RESUMEN - 1, f);
+    texto[n] = '\0';
+    fclose(f);
+    return texto;
+}
+
+// Ejecuta el programa una vez con el guion como entrada estándar
+static int correr(const char* programa, const char* guion, unsigned semilla,
+                  int limite_s, Corrida* c) {
+    char ruta_resumen[] = "/tmp/golden_resumenXXXXXX";
+    int fd = mkstemp(ruta_resumen);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 0;
+    }
+    close(fd);
+
+    double inicio = ahora_ms();
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 0;
+    }
+    if (pid == 0) {
+        int entrada = open(guion, O_RDONLY);
+        int nulo = open("/dev/null", O_WRONLY);
+        if (entrada < 0 || nulo < 0) _exit(127);
+        dup2(entrada, STDIN_FILENO);
+        dup2(nulo, STDOUT_FILENO);
+        dup2(nulo, STDERR_FILENO);
+        char valor[16];
+        snprintf(valor, sizeof(valor), "%u", semilla);
+        setenv("HOSPITAL_SEMILLA", valor, 1);
+        setenv("HOSPITAL_RESUMEN", ruta_resumen, 1);
+        setenv("TERM", "dumb", 1);
+        alarm(limite_s); // un guion desincronizado no debe colgar la corrida
+        const char* extension = strrchr(guion, '.');
+        if (extension && strcmp(extension, ".cmd") == 0)
+            execl(programa, programa, "--comandos", "-", (char*)NULL);
+        else
+            execl(programa, programa, (char*)NULL);
+        _exit(127);
+    }
+
+    int estado;
+    struct rusage uso;
+    if (wait4(pid, &estado, 0, &uso) < 0) {
+        perror("wait4");
+        return 0;
+    }
+    c->tiempo_ms = ahora_ms() - inicio;
+    c->rss_kb = uso.ru_maxrss;
+    c->estado = leer_archivo(ruta_resumen);
+    unlink(ruta_resumen);
+
+    if (WIFSIGNALED(estado)) {
+        fprintf(stderr, "%s termino por la senal %d%s\n", programa, WTERMSIG(estado),
+                WTERMSIG(estado) == SIGALRM ? " (supero --limite_s)" : "");
+        return 0;
+    }
+    if (WEXITSTATUS(estado) != 0) {
+        fprintf(stderr, "%s termino con codigo %d\n", programa, WEXITSTATUS(estado));
+        return 0;
+    }
+    if (!c->estado || !c->estado[0]) {
+        fprintf(stderr, "%s no escribio el resumen del estado\n", programa);
+        return 0;
+    }
+    return 1;
+}
+
+// Formato: líneas "clave valor" con los datos de rendimiento, una línea "---"
+// y después el resumen del estado tal como lo escribe el programa
+static int leer_referencia(const char* ruta, Referencia* r) {
+    char* texto = leer_archivo(ruta);
+    if (!texto) return 0;
+    char* separador = strstr(texto, "\n---\n");
+    if (!separador) {
+        fprintf(stderr, "%s no tiene el separador ---\n", ruta);
+        free(texto);
+        return 0;
+    }
+    *separador = '\0';
+    r->estado = strdup(separador + 5);
+
+    for (char* linea = strtok(texto, "\n"); linea; linea = strtok(NULL, "\n")) {
+        if (linea[0] == '#') continue;
+        sscanf(linea, "semilla %u", &r->semilla);
+        sscanf(linea, "tiempo_ms %lf", &r->tiempo_ms);
+        sscanf(linea, "rss_kb %ld", &r->rss_kb);
+    }
+    free(texto);
+    return 1;
+}
+
+static int escribir_referencia(const char* ruta, const char* guion, unsigned semilla,
+                               const Corrida* c) {
+    FILE* f = fopen(ruta, "w");
+    if (!f) {
+        perror("Error al escribir la referencia");
+        return 0;
+    }
+    fprintf(f, "# Referencia de %s (generada con golden --actualizar)\n", guion);
+    fprintf(f, "semilla %u\ntiempo_ms %.2f\nrss_kb %ld\n---\n%s", semilla,
+            c->tiempo_ms, c->rss_kb, c->estado);
+    fclose(f);
+    return 1;
+}
+
+// Muestra las primeras líneas distintas entre dos resúmenes
+static void mostrar_diferencias(const char* esperado, const char* obtenido) {
+    int mostradas = 0, linea = 1;
+    while ((*esperado || *obtenido) && mostradas < MAX_DIFERENCIAS) {
+        size_t le = strcspn(esperado, "\n"), lo = strcspn(obtenido, "\n");
+        if (le != lo || strncmp(esperado, obtenido, le) != 0) {
+            fprintf(stderr, "  linea %d\n    esperado: %.*s\n    obtenido: %.*s\n",
+                    linea, (int)le, esperado, (int)lo, obtenido);
+            mostradas++;
+        }
+        esperado += le + (esperado[le] == '\n');
+        obtenido += lo + (obtenido[lo] == '\n');
+        linea++;
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* programa = "./gestor_hospital";
+    const char* guion = NULL;
+    const char* ruta_ref = NULL;
+    long semilla = -1;
+    int repeticiones = 5;
+    double umbral = 0.20;
+    double holgura_ms = 5.0;
+    int limite_s = 60;
+    int actualizar = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* op = argv[i];
+        if (strcmp(op, "--actualizar") == 0) {
+            actualizar = 1;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Falta el valor de %s\n", op);
+            return 2;
+        }
+        const char* valor = argv[++i];
+        if (strcmp(op, "--programa") == 0) programa = valor;
+        else if (strcmp(op, "--guion") == 0) guion = valor;
+        else if (strcmp(op, "--referencia") == 0) ruta_ref = valor;
+        else if (strcmp(op, "--semilla") == 0) semilla = strtol(valor, NULL, 10);
+        else if (strcmp(op, "--repeticiones") == 0) repeticiones = atoi(valor);
+        else if (strcmp(op, "--umbral") == 0) umbral = atof(valor);
+        else if (strcmp(op, "--holgura_ms") == 0) holgura_ms = atof(valor);
+        else if (strcmp(op, "--limite_s") == 0) limite_s = atoi(valor);
+        else {
+            fprintf(stderr, "Opcion desconocida: %s\n", op);
+            return 2;
+        }
+    }
+    if (!guion) {
+        fprintf(stderr, "Uso: %s --guion archivo [--referencia archivo.ref] [--actualizar]\n", argv[0]);
+        return 2;
+    }
+    if (repeticiones < 1) repeticiones = 1;
+
+    // Por defecto la referencia va junto al guion: mes.txt -> mes.ref
+    char ruta_por_defecto[512];
+    if (!ruta_ref) {
+        snprintf(ruta_por_defecto, sizeof(ruta_por_defecto), "%s", guion);
+        char* punto = strrchr(ruta_por_defecto, '.');
+        if (punto && !strchr(punto, '/')) *punto = '\0';
+        strncat(ruta_por_defecto, ".ref", sizeof(ruta_por_defecto) - strlen(ruta_por_defecto) - 1);
+        ruta_ref = ruta_por_defecto;
+    }
+
+    Referencia ref = {42, 0, 0, NULL};
+    int hay_ref = leer_referencia(ruta_ref, &ref);
+    if (!hay_ref && !actualizar) {
+        fprintf(stderr, "No existe la referencia %s (use --actualizar para crearla)\n", ruta_ref);
+        return 2;
+    }
+    if (semilla >= 0) ref.semilla = (unsigned)semilla;
+
+    // Se queda con el mínimo de tiempo y de RSS: es lo menos afectado por ruido
+    Corrida mejor = {0, 0, NULL};
+    for (int r = 0; r < repeticiones; r++) {
+        Corrida c;
+        if (!correr(programa, guion, ref.semilla, limite_s, &c)) return 1;
+        if (mejor.estado && strcmp(mejor.estado, c.estado) != 0) {
+            fprintf(stderr, "La corrida %d no es reproducible: el estado cambio con la misma semilla\n", r + 1);
+            mostrar_diferencias(mejor.estado, c.estado);
+            return 1;
+        }
+        if (!mejor.estado) {
+            mejor = c;
+        } else {
+            if (c.tiempo_ms < mejor.tiempo_ms) mejor.tiempo_ms = c.tiempo_ms;
+            if (c.rss_kb < mejor.rss_kb) mejor.rss_kb = c.rss_kb;
+            free(c.estado);
+        }
+    }
+    printf("%s: %.2f ms, %ld KB de RSS (mejor de %d, semilla %u)\n", guion,
+           mejor.tiempo_ms, mejor.rss_kb, repeticiones, ref.semilla);
+
+    if (actualizar) {
+        if (!escribir_referencia(ruta_ref, guion, ref.semilla, &mejor)) return 2;
+        printf("Referencia actualizada: %s\n", ruta_ref);
+        return 0;
+    }
+
+    int fallo = 0;
+    if (strcmp(ref.estado, mejor.estado) != 0) {
+        fprintf(stderr, "El estado final no coincide con %s:\n", ruta_ref);
+        mostrar_diferencias(ref.estado, mejor.estado);
+        fallo = 1;
+    }
+    double tope_ms = ref.tiempo_ms * (1 + umbral) + holgura_ms;
+    printf("  tiempo: %.2f ms (referencia %.2f, tope %.2f)\n", mejor.tiempo_ms, ref.tiempo_ms, tope_ms);
+    if (mejor.tiempo_ms > tope_ms) {
+        fprintf(stderr, "Regresion de tiempo: %.2f ms > %.2f ms\n", mejor.tiempo_ms, tope_ms);
+        fallo = 1;
+    }
+    long tope_kb = (long)(ref.rss_kb * (1 + umbral));
+    printf("  RSS:    %ld KB (referencia %ld, tope %ld)\n", mejor.rss_kb, ref.rss_kb, tope_kb);
+    if (mejor.rss_kb > tope_kb) {
+        fprintf(stderr, "Regresion de memoria: %ld KB > %ld KB\n", mejor.rss_kb, tope_kb);
+        fallo = 1;
+    }
+    if (!fallo) printf("OK: el estado coincide y no hay regresiones\n");
+    return fallo;
+}
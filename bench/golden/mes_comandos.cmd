@@ -0,0 +1,931 @@
+# 30 dias con el lenguaje de comandos (ver gestion_hospital.c)
+# Cada dia: transferir a su area a los que llegaron, curar, distribuir desde Bodega, curar y cerrar
+# dia 1
+transfer 1
+transfer 2
+transfer 3
+transfer 4
+transfer 5
+transfer 6
+transfer 7
+transfer 8
+transfer 9
+transfer 10
+transfer 11
+transfer 12
+transfer 13
+transfer 14
+transfer 15
+transfer 16
+transfer 17
+transfer 18
+transfer 19
+transfer 20
+transfer 21
+transfer 22
+transfer 23
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 2
+transfer 7
+transfer 8
+transfer 9
+transfer 10
+transfer 11
+transfer 12
+transfer 13
+transfer 14
+transfer 15
+transfer 16
+transfer 17
+transfer 18
+transfer 19
+transfer 20
+transfer 21
+transfer 22
+transfer 23
+transfer 24
+transfer 25
+transfer 26
+transfer 27
+transfer 28
+transfer 29
+transfer 30
+transfer 31
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 3
+transfer 15
+transfer 16
+transfer 17
+transfer 18
+transfer 19
+transfer 20
+transfer 21
+transfer 22
+transfer 23
+transfer 24
+transfer 25
+transfer 26
+transfer 27
+transfer 28
+transfer 29
+transfer 30
+transfer 31
+transfer 32
+transfer 33
+transfer 34
+transfer 35
+transfer 36
+transfer 37
+transfer 38
+transfer 39
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 4
+transfer 23
+transfer 24
+transfer 25
+transfer 26
+transfer 27
+transfer 28
+transfer 29
+transfer 30
+transfer 31
+transfer 32
+transfer 33
+transfer 34
+transfer 35
+transfer 36
+transfer 37
+transfer 38
+transfer 39
+transfer 40
+transfer 41
+transfer 42
+transfer 43
+transfer 44
+transfer 45
+transfer 46
+transfer 47
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 5
+transfer 31
+transfer 32
+transfer 33
+transfer 34
+transfer 35
+transfer 36
+transfer 37
+transfer 38
+transfer 39
+transfer 40
+transfer 41
+transfer 42
+transfer 43
+transfer 44
+transfer 45
+transfer 46
+transfer 47
+transfer 48
+transfer 49
+transfer 50
+transfer 51
+transfer 52
+transfer 53
+transfer 54
+transfer 55
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 6
+transfer 39
+transfer 40
+transfer 41
+transfer 42
+transfer 43
+transfer 44
+transfer 45
+transfer 46
+transfer 47
+transfer 48
+transfer 49
+transfer 50
+transfer 51
+transfer 52
+transfer 53
+transfer 54
+transfer 55
+transfer 56
+transfer 57
+transfer 58
+transfer 59
+transfer 60
+transfer 61
+transfer 62
+transfer 63
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 7
+transfer 47
+transfer 48
+transfer 49
+transfer 50
+transfer 51
+transfer 52
+transfer 53
+transfer 54
+transfer 55
+transfer 56
+transfer 57
+transfer 58
+transfer 59
+transfer 60
+transfer 61
+transfer 62
+transfer 63
+transfer 64
+transfer 65
+transfer 66
+transfer 67
+transfer 68
+transfer 69
+transfer 70
+transfer 71
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 8
+transfer 55
+transfer 56
+transfer 57
+transfer 58
+transfer 59
+transfer 60
+transfer 61
+transfer 62
+transfer 63
+transfer 64
+transfer 65
+transfer 66
+transfer 67
+transfer 68
+transfer 69
+transfer 70
+transfer 71
+transfer 72
+transfer 73
+transfer 74
+transfer 75
+transfer 76
+transfer 77
+transfer 78
+transfer 79
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 9
+transfer 63
+transfer 64
+transfer 65
+transfer 66
+transfer 67
+transfer 68
+transfer 69
+transfer 70
+transfer 71
+transfer 72
+transfer 73
+transfer 74
+transfer 75
+transfer 76
+transfer 77
+transfer 78
+transfer 79
+transfer 80
+transfer 81
+transfer 82
+transfer 83
+transfer 84
+transfer 85
+transfer 86
+transfer 87
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 10
+transfer 71
+transfer 72
+transfer 73
+transfer 74
+transfer 75
+transfer 76
+transfer 77
+transfer 78
+transfer 79
+transfer 80
+transfer 81
+transfer 82
+transfer 83
+transfer 84
+transfer 85
+transfer 86
+transfer 87
+transfer 88
+transfer 89
+transfer 90
+transfer 91
+transfer 92
+transfer 93
+transfer 94
+transfer 95
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 11
+transfer 79
+transfer 80
+transfer 81
+transfer 82
+transfer 83
+transfer 84
+transfer 85
+transfer 86
+transfer 87
+transfer 88
+transfer 89
+transfer 90
+transfer 91
+transfer 92
+transfer 93
+transfer 94
+transfer 95
+transfer 96
+transfer 97
+transfer 98
+transfer 99
+transfer 100
+transfer 101
+transfer 102
+transfer 103
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 12
+transfer 87
+transfer 88
+transfer 89
+transfer 90
+transfer 91
+transfer 92
+transfer 93
+transfer 94
+transfer 95
+transfer 96
+transfer 97
+transfer 98
+transfer 99
+transfer 100
+transfer 101
+transfer 102
+transfer 103
+transfer 104
+transfer 105
+transfer 106
+transfer 107
+transfer 108
+transfer 109
+transfer 110
+transfer 111
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 13
+transfer 95
+transfer 96
+transfer 97
+transfer 98
+transfer 99
+transfer 100
+transfer 101
+transfer 102
+transfer 103
+transfer 104
+transfer 105
+transfer 106
+transfer 107
+transfer 108
+transfer 109
+transfer 110
+transfer 111
+transfer 112
+transfer 113
+transfer 114
+transfer 115
+transfer 116
+transfer 117
+transfer 118
+transfer 119
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 14
+transfer 103
+transfer 104
+transfer 105
+transfer 106
+transfer 107
+transfer 108
+transfer 109
+transfer 110
+transfer 111
+transfer 112
+transfer 113
+transfer 114
+transfer 115
+transfer 116
+transfer 117
+transfer 118
+transfer 119
+transfer 120
+transfer 121
+transfer 122
+transfer 123
+transfer 124
+transfer 125
+transfer 126
+transfer 127
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 15
+transfer 111
+transfer 112
+transfer 113
+transfer 114
+transfer 115
+transfer 116
+transfer 117
+transfer 118
+transfer 119
+transfer 120
+transfer 121
+transfer 122
+transfer 123
+transfer 124
+transfer 125
+transfer 126
+transfer 127
+transfer 128
+transfer 129
+transfer 130
+transfer 131
+transfer 132
+transfer 133
+transfer 134
+transfer 135
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 16
+transfer 119
+transfer 120
+transfer 121
+transfer 122
+transfer 123
+transfer 124
+transfer 125
+transfer 126
+transfer 127
+transfer 128
+transfer 129
+transfer 130
+transfer 131
+transfer 132
+transfer 133
+transfer 134
+transfer 135
+transfer 136
+transfer 137
+transfer 138
+transfer 139
+transfer 140
+transfer 141
+transfer 142
+transfer 143
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 17
+transfer 127
+transfer 128
+transfer 129
+transfer 130
+transfer 131
+transfer 132
+transfer 133
+transfer 134
+transfer 135
+transfer 136
+transfer 137
+transfer 138
+transfer 139
+transfer 140
+transfer 141
+transfer 142
+transfer 143
+transfer 144
+transfer 145
+transfer 146
+transfer 147
+transfer 148
+transfer 149
+transfer 150
+transfer 151
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 18
+transfer 135
+transfer 136
+transfer 137
+transfer 138
+transfer 139
+transfer 140
+transfer 141
+transfer 142
+transfer 143
+transfer 144
+transfer 145
+transfer 146
+transfer 147
+transfer 148
+transfer 149
+transfer 150
+transfer 151
+transfer 152
+transfer 153
+transfer 154
+transfer 155
+transfer 156
+transfer 157
+transfer 158
+transfer 159
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 19
+transfer 143
+transfer 144
+transfer 145
+transfer 146
+transfer 147
+transfer 148
+transfer 149
+transfer 150
+transfer 151
+transfer 152
+transfer 153
+transfer 154
+transfer 155
+transfer 156
+transfer 157
+transfer 158
+transfer 159
+transfer 160
+transfer 161
+transfer 162
+transfer 163
+transfer 164
+transfer 165
+transfer 166
+transfer 167
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 20
+transfer 151
+transfer 152
+transfer 153
+transfer 154
+transfer 155
+transfer 156
+transfer 157
+transfer 158
+transfer 159
+transfer 160
+transfer 161
+transfer 162
+transfer 163
+transfer 164
+transfer 165
+transfer 166
+transfer 167
+transfer 168
+transfer 169
+transfer 170
+transfer 171
+transfer 172
+transfer 173
+transfer 174
+transfer 175
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 21
+transfer 159
+transfer 160
+transfer 161
+transfer 162
+transfer 163
+transfer 164
+transfer 165
+transfer 166
+transfer 167
+transfer 168
+transfer 169
+transfer 170
+transfer 171
+transfer 172
+transfer 173
+transfer 174
+transfer 175
+transfer 176
+transfer 177
+transfer 178
+transfer 179
+transfer 180
+transfer 181
+transfer 182
+transfer 183
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 22
+transfer 167
+transfer 168
+transfer 169
+transfer 170
+transfer 171
+transfer 172
+transfer 173
+transfer 174
+transfer 175
+transfer 176
+transfer 177
+transfer 178
+transfer 179
+transfer 180
+transfer 181
+transfer 182
+transfer 183
+transfer 184
+transfer 185
+transfer 186
+transfer 187
+transfer 188
+transfer 189
+transfer 190
+transfer 191
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 23
+transfer 175
+transfer 176
+transfer 177
+transfer 178
+transfer 179
+transfer 180
+transfer 181
+transfer 182
+transfer 183
+transfer 184
+transfer 185
+transfer 186
+transfer 187
+transfer 188
+transfer 189
+transfer 190
+transfer 191
+transfer 192
+transfer 193
+transfer 194
+transfer 195
+transfer 196
+transfer 197
+transfer 198
+transfer 199
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 24
+transfer 183
+transfer 184
+transfer 185
+transfer 186
+transfer 187
+transfer 188
+transfer 189
+transfer 190
+transfer 191
+transfer 192
+transfer 193
+transfer 194
+transfer 195
+transfer 196
+transfer 197
+transfer 198
+transfer 199
+transfer 200
+transfer 201
+transfer 202
+transfer 203
+transfer 204
+transfer 205
+transfer 206
+transfer 207
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 25
+transfer 191
+transfer 192
+transfer 193
+transfer 194
+transfer 195
+transfer 196
+transfer 197
+transfer 198
+transfer 199
+transfer 200
+transfer 201
+transfer 202
+transfer 203
+transfer 204
+transfer 205
+transfer 206
+transfer 207
+transfer 208
+transfer 209
+transfer 210
+transfer 211
+transfer 212
+transfer 213
+transfer 214
+transfer 215
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 26
+transfer 199
+transfer 200
+transfer 201
+transfer 202
+transfer 203
+transfer 204
+transfer 205
+transfer 206
+transfer 207
+transfer 208
+transfer 209
+transfer 210
+transfer 211
+transfer 212
+transfer 213
+transfer 214
+transfer 215
+transfer 216
+transfer 217
+transfer 218
+transfer 219
+transfer 220
+transfer 221
+transfer 222
+transfer 223
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 27
+transfer 207
+transfer 208
+transfer 209
+transfer 210
+transfer 211
+transfer 212
+transfer 213
+transfer 214
+transfer 215
+transfer 216
+transfer 217
+transfer 218
+transfer 219
+transfer 220
+transfer 221
+transfer 222
+transfer 223
+transfer 224
+transfer 225
+transfer 226
+transfer 227
+transfer 228
+transfer 229
+transfer 230
+transfer 231
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 28
+transfer 215
+transfer 216
+transfer 217
+transfer 218
+transfer 219
+transfer 220
+transfer 221
+transfer 222
+transfer 223
+transfer 224
+transfer 225
+transfer 226
+transfer 227
+transfer 228
+transfer 229
+transfer 230
+transfer 231
+transfer 232
+transfer 233
+transfer 234
+transfer 235
+transfer 236
+transfer 237
+transfer 238
+transfer 239
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 29
+transfer 223
+transfer 224
+transfer 225
+transfer 226
+transfer 227
+transfer 228
+transfer 229
+transfer 230
+transfer 231
+transfer 232
+transfer 233
+transfer 234
+transfer 235
+transfer 236
+transfer 237
+transfer 238
+transfer 239
+transfer 240
+transfer 241
+transfer 242
+transfer 243
+transfer 244
+transfer 245
+transfer 246
+transfer 247
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+# dia 30
+transfer 231
+transfer 232
+transfer 233
+transfer 234
+transfer 235
+transfer 236
+transfer 237
+transfer 238
+transfer 239
+transfer 240
+transfer 241
+transfer 242
+transfer 243
+transfer 244
+transfer 245
+transfer 246
+transfer 247
+transfer 248
+transfer 249
+transfer 250
+transfer 251
+transfer 252
+transfer 253
+transfer 254
+transfer 255
+cure all
+withdraw 1005 10 UCI
+distribute
+cure all
+endday
+stats
@@ -1,64 +1,326 @@
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <limits.h>
 #include "tdas/extra.h"
 #include "tdas/list.h"
+#include "tdas/heap.h"
+#include "tdas/hashmap.h"
+#include "tdas/arraylist.h"
+#include "tdas/trie.h"
+#include "tdas/interner.h"
+#include "tdas/memoria.h"
+#include "tdas/metricas.h"
+#include "tdas/traza.h"
+#include "tdas/servidor.h"
+#include "tdas/epoca.h"
+#include "tdas/escritor.h"
+#include "tdas/texto.h"
+#include "tdas/pantalla.h"
+#include <signal.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
 
 #define MAX_LINEA 512
 
+// Fechas de vencimiento: se guardan como número de día (días desde
+// 1970-01-01) y el día de simulación N corresponde a FECHA_INICIO + N
+#define FECHA_INICIO_SIMULACION "2025-06-01"
+#define SIN_VENCIMIENTO         INT_MAX
+#define VIDA_UTIL_MINIMA        30   // días de vida útil de un lote repuesto, como mínimo
+
+// Pronóstico de demanda (promedio móvil exponencial) y pedidos automáticos
+#define ALFA_DEMANDA       0.3   // peso del consumo del último día
+#define FACTOR_SEGURIDAD   1.65  // desviaciones de stock de seguridad (~95%)
+#define DIAS_COBERTURA     3     // días de demanda que cubre cada pedido
+#define TOPE_BODEGA        200   // unidades máximas de un insumo en Bodega
+
 // ----------------------------------------------------
 // Estructuras principales
 // ----------------------------------------------------
 
+// Datos fríos del paciente: sólo se leen al mostrarlo o buscarlo. Los campos
+// que usa la simulación en cada turno viven en AlmacenPacientes.
 typedef struct {
     int id;
+    int handle;           // posición en los arreglos de AlmacenPacientes
     char nombre[50];
     char apellido[50];
     int edad;
-    char area[50];
+    Simbolo area;         // nombre del área (internado)
     char diagnostico[100];
-    int gravedad;         // 1: leve, 2: moderada, 3: grave
-    int turnos_espera;    // contador de turnos en Sala de Espera
-    int insumo_req_id;    // ID del insumo que necesita
-    int cantidad_req;     // cuántas unidades de ese insumo requiere
+    int sala_area;        // ID de la sala de su área (-1 si no existe)
 } Paciente;
 
+// Almacén de pacientes indexado por handle. Los campos calientes están en
+// arreglos paralelos (uno por campo) para que los recorridos de cada turno
+// lean memoria contigua; los datos fríos quedan aparte en fichas.
+//
+// Las fichas se piden en bloques (uno por cada vez que crece el almacén) y
+// cada handle conserva la suya: al dar de alta a un paciente su handle y su
+// ficha vuelven a usarse con el siguiente que llega, sin malloc ni free.
+typedef struct {
+    int* gravedad;        // 1: leve, 2: moderada, 3: grave
+    int* turnos_espera;   // contador de turnos en Sala de Espera
+    int* insumo_req_id;   // ID del insumo que necesita
+    int* cantidad_req;    // cuántas unidades de ese insumo requiere
+    int* sala;            // ID de la sala donde se encuentra (-1 si no está en una)
+    int* pos_sala;        // posición en el arreglo de pacientes de esa sala
+    Paciente** fichas;    // datos fríos; apunta dentro de un bloque (fijo por handle)
+    int capacidad;
+    int usados;           // handles entregados alguna vez: 0..usados-1
+    int* libres;          // handles devueltos al dar de alta, se reutilizan primero
+    int num_libres;
+    Paciente** bloques;   // memoria de las fichas, un bloque por crecimiento
+    int num_bloques;
+    int maximo_vivos;     // mayor cantidad de pacientes vivos a la vez
+} AlmacenPacientes;
+
+// Metadatos de un insumo: hay una sola copia por ID en el catálogo y las
+// salas sólo guardan (posición en el catálogo, cantidad, lotes). tipo y unidad
+// se repiten entre insumos: se guardan como símbolos internados.
 typedef struct {
     int id;
+    int indice;                 // posición en el catálogo
     char nombre[100];
-    char tipo[50];
-    int cantidad;
-    char unidad[30];
-    char fecha_vencimiento[20]; // puede estar vacío
-    char ubicacion[50];
+    Simbolo tipo;
+    Simbolo unidad;
+    int vida_util;              // días que dura un lote nuevo (SIN_VENCIMIENTO si no vence)
 } Insumo;
 
+// Demanda de un insumo en todo el hospital. El consumo se acumula en el día y
+// al cierre actualiza el promedio y la desviación (ambos exponenciales).
+typedef struct {
+    int consumo_hoy;
+    double promedio;            // unidades por día
+    double desviacion;          // desviación absoluta media, unidades por día
+    int dias;                   // días observados
+    int stock;                  // unidades en todas las salas (incluida Bodega)
+    int punto_pedido;           // se pide cuando stock <= punto_pedido
+    int cantidad_pedido;        // último pedido automático
+} DemandaInsumo;
+
+typedef struct {
+    Insumo** insumos;           // posición -> Insumo*
+    DemandaInsumo* demanda;     // posición -> demanda del insumo
+    int cantidad;
+    int capacidad;
+    HashMap* por_id;            // id -> Insumo*
+} CatalogoInsumos;
+
+// Unidades de un insumo con la misma fecha de vencimiento
+typedef struct {
+    int vence;                  // número de día (SIN_VENCIMIENTO si no vence)
+    int cantidad;
+} Lote;
+
+// Unidades de un insumo del catálogo en una sala. Los lotes están en un heap
+// ordenado por vencimiento (el primero en vencer arriba) y cantidad es la
+// suma de todos ellos.
+typedef struct {
+    int catalogo;               // posición del insumo en el catálogo
+    int sala;                   // ID de la sala donde está
+    int cantidad;
+    Heap* lotes;                // Lote*, prioridad = -vence
+} Existencia;
+
+// Fila de insumos.csv: cuántas unidades de qué insumo van a qué sala
+typedef struct {
+    int catalogo;
+    int cantidad;
+    int vence;                  // fecha_vencimiento de la fila, ya convertida
+    Simbolo ubicacion;          // nombre de la sala
+} CargaInsumo;
+
 typedef struct {
     int id_insumo;
     int cantidad_total;    // stock real en Bodega
     int retirado_hoy;      // cuántas unidades de este ítem ya se retiraron hoy
 } StockDiario;
 
+// Tipos de sala (columnas tipo y bodega de salas.csv)
+#define SALA_ESPERA  0
+#define SALA_CLINICA 1
+#define SALA_BODEGA  2
+
 typedef struct {
+    int id;                // posición en la tabla de salas
     char nombre[50];
+    Simbolo simbolo;       // nombre internado
+    int tipo;              // SALA_ESPERA, SALA_CLINICA o SALA_BODEGA
     int capacidad_pacientes;
     int capacidad_insumos;
-    List* pacientes;
-    List* insumos;
+    int* pacientes;        // handles en orden de llegada
+    int num_pacientes;
+    int cap_pacientes;
+    Existencia* insumos;   // contiguo; el orden no importa
+    int num_insumos;
+    int cap_insumos;
     List* stock_diario;    // sólo se usa para Bodega Central
+    HashMap* indice_insumos; // id -> Existencia* de la sala
+    HashMap* indice_stock;   // id -> StockDiario* (sólo Bodega Central)
+    int por_gravedad[4];     // pacientes en la sala según gravedad (1..3)
+    int en_peligro;          // gravedad 3 con 2 o más turnos de espera
+    int prioridad_critica;   // columna criticos: 0 si no recibe gravedad 3
+    int cambiada;            // pacientes o insumos distintos de la última vista
 } Sala;
 
+// Tabla contigua de salas cargada desde salas.csv; el ID de una sala es su
+// posición en el arreglo.
+typedef struct {
+    Sala* salas;
+    int cantidad;
+    HashMap* por_nombre;   // nombre -> Sala*
+    HashMap* por_simbolo;  // símbolo del nombre -> Sala*
+    int id_espera;         // -1 si no hay Sala de Espera
+    int id_bodega;         // -1 si no hay Bodega
+    int* clinicas;         // IDs de las salas clínicas (áreas de los pacientes)
+    int num_clinicas;
+    int* criticas;         // IDs de las que reciben gravedad 3 desde la Sala de
+    int num_criticas;      // Espera, en orden de preferencia
+} TablaSalas;
+
+// Índices secundarios sobre los pacientes vivos del hospital. Cada índice
+// agrupa por el valor de un campo (valor -> GrupoIndice) y cada grupo es un
+// conjunto id -> Paciente*, así que agregar o quitar un paciente es O(1).
+#define MAX_TURNOS_INDICE 8   // los pacientes con más turnos comparten grupo
+
+typedef struct {
+    int clave;             // valor del campo indexado
+    HashMap* pacientes;    // id -> Paciente*
+} GrupoIndice;
+
+typedef struct {
+    HashMap* por_gravedad; // 1..3
+    HashMap* por_area;     // ID de la sala del área (-1 si no existe)
+    HashMap* por_insumo;   // ID del insumo requerido
+    HashMap* por_turnos;   // turnos de espera (tope MAX_TURNOS_INDICE)
+    Trie* por_texto;       // nombre, apellido y diagnóstico, desde cada palabra
+    int total;             // pacientes indexados
+} IndicesPacientes;
+
+// Filtros de una consulta; los campos en su valor "cualquiera" no filtran.
+typedef struct {
+    const char* texto;     // prefijo de nombre, apellido o diagnóstico; NULL o "": cualquiera
+    int gravedad;          // 0: cualquiera
+    int sala_area;         // -1: cualquiera
+    int insumo_id;         // 0: cualquiera
+    int turnos_min;        // 0: sin mínimo
+    int turnos_max;        // -1: sin máximo
+    int sala;              // -1: cualquiera (sala donde está ahora)
+} ConsultaPacientes;
+
+// Copia inmutable de lo que muestran las pantallas de estado, tomada al final
+// de un turno. Se publica para que otros hilos la lean sin tocar las salas.
+typedef struct {
+    int id;
+    char nombre[50];
+    char apellido[50];
+    int gravedad;
+    int turnos_espera;
+    int insumo_req_id;
+    int cantidad_req;
+} VistaPaciente;
+
+typedef struct {
+    int id;
+    char nombre[100];
+    const char* unidad;    // cadena internada: vive hasta el final
+    int cantidad;
+    int lotes;
+    char vence[20];        // próximo vencimiento, ya como fecha
+} VistaInsumo;
+
+// Las vistas sucesivas comparten las VistaSala de las salas que no cambiaron
+typedef struct {
+    char nombre[50];
+    int capacidad_pacientes;
+    int capacidad_insumos;
+    int num_pacientes;
+    int num_insumos;
+    int por_gravedad[4];
+    VistaPaciente* pacientes;
+    VistaInsumo* insumos;
+    int refs;              // vistas que la usan; sólo la toca la simulación
+} VistaSala;
+
+typedef struct {
+    long version;          // crece con cada vista publicada
+    int dia;
+    int curados;
+    int fallecidos;
+    int reputacion;
+    int graves;
+    int en_peligro;        // gravedad 3 en Sala de Espera a un turno de morir
+    int fichas_vivas;
+    int fichas_libres;
+    int fichas_maximo;
+    int fichas_bloques;
+    int num_salas;
+    VistaSala** salas;
+} VistaHospital;
+
 // ----------------------------------------------------
 // Variables globales
 // ----------------------------------------------------
 
-List* salas_global;            // lista de todas las salas
+TablaSalas* salas_global;      // tabla de todas las salas
+AlmacenPacientes almacen;      // todos los pacientes vivos, por handle
+Interner* simbolos = NULL;     // cadenas internadas (áreas, tipos, unidades, ubicaciones)
+CatalogoInsumos catalogo;      // metadatos de todos los insumos conocidos
 int pacientes_curados = 0;
 int pacientes_fallecidos = 0;
 int reputacion = 0;
 int dia_actual = 0;
-int siguiente_id_paciente = 6; // asume que ya cargamos 5 pacientes del CSV inicial
+int siguiente_id_paciente = 1; // se ajusta al mayor ID cargado del CSV + 1
+
+// Insumo que requieren los pacientes nuevos según su gravedad (tratamientos.csv);
+// insumo_id 0: esa gravedad no tiene tratamiento configurado
+typedef struct {
+    int insumo_id;
+    int cantidad;
+} Tratamiento;
+Tratamiento tratamientos[4];
+int pacientes_por_gravedad[4] = {0}; // totales del hospital, se mantienen al mover pacientes
+IndicesPacientes indices;            // índices secundarios de los pacientes vivos
+Publicacion* vistas = NULL;          // última VistaHospital publicada
+
+// stdout pasa por un escritor asíncrono (ver iniciar_salida_asincrona) y, en
+// una terminal, por la pantalla con cuadros (ver iniciar_pantalla)
+struct {
+    Escritor* escritor;         // NULL: stdout escribe directo
+    FILE* original;             // stdout de la biblioteca, se restaura al salir
+    Pantalla* pantalla;         // NULL: texto plano, sin secuencias ANSI
+    FILE* debajo;               // stdout antes de la pantalla
+} salida;
+
+// Métricas del programa: se exportan al cerrar cada día si se definió
+// HOSPITAL_METRICAS con la ruta del archivo
+struct {
+    const char* archivo;        // NULL: no se exportan
+    Histograma* atender;        // curar un paciente elegido (sin contar la entrada)
+    Histograma* curar_lote;
+    Histograma* transferir;     // transferir un paciente elegido
+    Histograma* distribuir;     // retiro manual de Bodega a una sala
+    Histograma* distribuir_optimizado;
+    Histograma* fin_dia;        // ejecutar_procesos_fin_dia
+    Histograma* espera_comando; // de leída la línea a ejecutada (--tiempo-real)
+    Contador* curados;
+    Contador* fallecidos;
+    Contador* transferencias;   // manuales y automáticas
+    Contador* unidades_retiradas;
+    Contador* dia;
+    Contador* pacientes;        // pacientes en el hospital
+    Contador* salida_bytes;     // escritos por la salida asíncrona
+    Contador* salida_escrituras;
+    Contador* salida_esperas;   // veces que la simulación encontró el anillo lleno
+    Contador* cierres_automaticos; // días cerrados por el reloj (--tiempo-real)
+} metricas;
 
 #define BASE_RETIRAR             50   // unidades mínimas que puedes retirar sin reputación
 #define MULTIPLICADOR_REPUTACION 5    // por cada punto de reputación, se añade esta cantidad
@@ -70,45 +332,296 @@ int siguiente_id_paciente = 6; // asume que ya cargamos 5 pacientes del CSV inic
 // Lectura CSV
 List* leer_pacientes(FILE* archivo);
 List* leer_insumos(FILE* archivo);
+TablaSalas* leer_salas(FILE* archivo);
+int leer_tratamientos(FILE* archivo);
+
+// Cadenas internadas
+Simbolo simbolo(const char* texto);
+const char* texto_simbolo(Simbolo s);
+
+// Catálogo de insumos
+Insumo* insumo_por_id(int id);
+Insumo* registrar_insumo(Insumo* datos);
+Insumo* ficha_insumo(Existencia* e);
+DemandaInsumo* demanda_insumo(Existencia* e);
+
+// Lotes y vencimientos
+int dia_desde_fecha(const char* fecha);
+void fecha_desde_dia(int dia, char* fecha);
+int fecha_hoy();
+int vence_reposicion(Insumo* ins);
+void agregar_lote(Existencia* e, int vence, int cantidad);
+int consumir_lotes(Existencia* e, int cantidad, Existencia* destino);
+int purgar_vencidos(Existencia* e, int hoy);
+int proximo_vencimiento(Existencia* e);
+
+// Almacén de pacientes
+int crear_paciente();
+int reservar_pacientes(int n);
+void liberar_paciente(int h);
+Paciente* ficha_paciente(int h);
 
 // Salas y asignaciones iniciales
-Sala* crear_sala(const char* nombre, int cap_pacientes, int cap_insumos);
-List* inicializar_salas();
-Sala* buscar_sala(List* salas, const char* nombre);
-void asignar_pacientes_a_espera(List* pacientes, List* salas);
-void asignar_insumos_a_salas(List* insumos, List* salas);
-
-// Mostrar estado
-void mostrar_salas(List* salas);
+void inicializar_sala(Sala* s, int id, const char* nombre, int tipo,
+                      int cap_pacientes, int cap_insumos);
+Sala* sala_por_id(TablaSalas* salas, int id);
+Sala* sala_espera(TablaSalas* salas);
+Sala* sala_critica_con_cupo(TablaSalas* salas, int* desde);
+Sala* sala_bodega(TablaSalas* salas);
+Sala* buscar_sala(TablaSalas* salas, const char* nombre);
+Sala* buscar_sala_simbolo(TablaSalas* salas, Simbolo nombre);
+Existencia* buscar_insumo(Sala* sala, int id);
+StockDiario* buscar_stock(Sala* bodega, int id);
+Existencia* existencia_sala(Sala* sala, Insumo* ins);
+Existencia* agregar_insumo_sala(Sala* sala, Insumo* ins, int cantidad, int vence);
+void agregar_stock_bodega(Sala* bodega, StockDiario* sd);
+StockDiario* stock_bodega(Sala* bodega, Insumo* ins);
+void quitar_insumo_sala(Sala* sala, Existencia* e);
+void registrar_entrada_sala(Sala* sala, int h);
+void registrar_salida_sala(Sala* sala, int h);
+int sala_agregar_paciente(Sala* sala, int h);
+int sala_quitar_paciente(Sala* sala, int pos);
+void avanzar_turno_espera(Sala* sala);
+void asignar_pacientes_a_espera(List* pacientes, TablaSalas* salas);
+void asignar_insumos_a_salas(List* insumos, TablaSalas* salas);
+
+// Índices secundarios y consultas
+void inicializar_indices();
+void admitir_paciente(int h);
+void dar_alta_paciente(int h);
+void reindexar_turnos(int h, int turnos_antes);
+int buscar_paciente(int id);
+void consulta_vacia(ConsultaPacientes* c);
+int consultar_pacientes(TablaSalas* salas, ConsultaPacientes* c, ArrayList* resultado);
+void buscar_pacientes_menu(TablaSalas* salas);
+
+// Vistas del estado y mostrar estado
+VistaHospital* construir_vista(TablaSalas* salas, const VistaHospital* anterior);
+void publicar_vista();
+void texto_salas(Texto* t, const VistaHospital* v);
+void texto_resumen_salas(Texto* t, const VistaHospital* v, int gravedad_min);
+void escribir_encabezado(FILE* f, const VistaHospital* v);
+void escribir_estadisticas(FILE* f, const VistaHospital* v);
+int iniciar_panel(const char* ruta, int periodo_ms);
+void detener_panel();
+void mostrar_salas();
 
 // Transferencia manual
-void transferir_pacientes_menu(List* salas);
-void transferir_paciente_unico(List* salas, Paciente* p);
+void transferir_pacientes_menu(TablaSalas* salas);
+int transferir_paciente_unico(TablaSalas* salas, int pos);
+int mover_desde_espera(TablaSalas* salas, int pos, Sala* destino);
+
+// Métricas
+void inicializar_metricas();
+void exportar_metricas();
+
+// Salida asíncrona
+void iniciar_salida_asincrona();
+void terminar_salida_asincrona();
+void iniciar_pantalla();
+void terminar_pantalla();
+void limpiar_pantalla();
 
 // Sistema de turnos y muertes
-void ejecutar_turno(List* salas);
 void ejecutar_procesos_fin_dia();
+int retirar_insumos_vencidos(TablaSalas* salas);
+
+// Pronóstico de demanda y pedidos automáticos
+void registrar_consumo(Existencia* e, int cantidad);
+void actualizar_pronostico(DemandaInsumo* d);
+int generar_pedidos_automaticos(TablaSalas* salas);
 
 // Generar pacientes aleatorios
 void generar_pacientes_nuevos();
 
 // Menu de gestión diario
+int leer_opcion(int al_terminar);
 void mostrar_encabezado();
+int comenzar_dia();
+void cerrar_dia();
 void ciclo_diario();
 
+// Lenguaje de comandos
+#define COMANDO_OK    0
+#define COMANDO_ERROR 1
+#define COMANDO_SALIR 2
+#define COMANDO_VACIO 3   // línea vacía o comentario: no hay respuesta
+int ejecutar_comando(char* linea, char* respuesta, size_t tam);
+int procesar_comandos(FILE* entrada);
+int atender_servidor(const char* ruta);
+int atender_tiempo_real(double segundos);
+
 // Atender pacientes
-void atender_paciente(List* salas);
+#define CURA_OK                 0
+#define CURA_SIN_INSUMO         1   // la sala no tiene el insumo requerido
+#define CURA_STOCK_INSUFICIENTE 2
+void atender_paciente(TablaSalas* salas);
+int curar_paciente(Sala* sala, int pos);
+int curar_lote_sala(Sala* sala);
+void curar_pacientes_lote(TablaSalas* salas, Sala* sala);
 void mostrar_estadisticas();
+void escribir_resumen_estado(FILE* f);
 
 // Gestión de Bodega
-void gestionar_bodega(List* salas, int* limite_diario);
-void pedir_insumos_proveedor(List* salas);
-void distribuir_insumos_a_salass(List* salas, int* limite_diario);
+void gestionar_bodega(TablaSalas* salas, int* limite_diario);
+void pedir_insumos_proveedor(TablaSalas* salas);
+void distribuir_insumos_a_salass(TablaSalas* salas, int* limite_diario);
+const char* validar_retiro(StockDiario* sd, int cantidad, int limite_diario);
+Insumo* retirar_de_bodega(Sala* bodega, StockDiario* sd, Sala* destino,
+                          int cantidad, int* limite_diario);
+void distribuir_insumos_optimizado(TablaSalas* salas, int* limite_diario);
 
 // ----------------------------------------------------
 // Implementaciones
 // ----------------------------------------------------
 
+// ----------------------------------------------------
+// Cadenas internadas
+// ----------------------------------------------------
+Simbolo simbolo(const char* texto) {
+    if (!simbolos) simbolos = interner_create();
+    return interner_intern(simbolos, texto);
+}
+
+const char* texto_simbolo(Simbolo s) {
+    return interner_text(simbolos, s);
+}
+
+// ----------------------------------------------------
+// Métricas: tiempos por operación y contadores de eventos
+// ----------------------------------------------------
+void inicializar_metricas() {
+    metricas.atender = metricas_histograma("hospital_atender_paciente_seconds",
+        "Tiempo de curar un paciente elegido en atender_paciente");
+    metricas.curar_lote = metricas_histograma("hospital_curar_lote_seconds",
+        "Tiempo de curar en lote una sala o todo el hospital");
+    metricas.transferir = metricas_histograma("hospital_transferir_paciente_seconds",
+        "Tiempo de transferir un paciente desde Sala de Espera");
+    metricas.distribuir = metricas_histograma("hospital_distribuir_insumos_seconds",
+        "Tiempo de un retiro manual de Bodega a una sala");
+    metricas.distribuir_optimizado = metricas_histograma("hospital_distribuir_optimizado_seconds",
+        "Tiempo de calcular y aplicar la distribucion optimizada");
+    metricas.fin_dia = metricas_histograma("hospital_fin_dia_seconds",
+        "Tiempo de ejecutar_procesos_fin_dia");
+    metricas.espera_comando = metricas_histograma("hospital_espera_comando_seconds",
+        "Tiempo desde que se lee un comando hasta que se ejecuta en modo tiempo real");
+    metricas.curados = metricas_contador("hospital_pacientes_curados_total",
+        "Pacientes curados");
+    metricas.fallecidos = metricas_contador("hospital_pacientes_fallecidos_total",
+        "Pacientes fallecidos en Sala de Espera");
+    metricas.transferencias = metricas_contador("hospital_transferencias_total",
+        "Pacientes transferidos desde Sala de Espera (manual o automaticamente)");
+    metricas.unidades_retiradas = metricas_contador("hospital_unidades_retiradas_total",
+        "Unidades de insumos retiradas de Bodega hacia las salas");
+    metricas.dia = metricas_indicador("hospital_dia", "Dia de simulacion");
+    metricas.pacientes = metricas_indicador("hospital_pacientes",
+        "Pacientes en el hospital");
+    metricas.salida_bytes = metricas_indicador("hospital_salida_bytes",
+        "Bytes escritos por la salida asincrona");
+    metricas.salida_escrituras = metricas_indicador("hospital_salida_escrituras",
+        "Llamadas a write de la salida asincrona");
+    metricas.salida_esperas = metricas_indicador("hospital_salida_esperas",
+        "Veces que la simulacion espero porque la salida iba atrasada");
+    metricas.cierres_automaticos = metricas_contador("hospital_cierres_automaticos_total",
+        "Dias cerrados por el reloj en modo tiempo real");
+}
+
+void exportar_metricas() {
+    if (!metricas.archivo) return;
+    indicador_fijar(metricas.dia, dia_actual);
+    indicador_fijar(metricas.pacientes, almacen.usados - almacen.num_libres);
+    if (salida.escritor) {
+        long bytes, escrituras, esperas;
+        escritor_estadisticas(salida.escritor, &bytes, &escrituras, &esperas);
+        indicador_fijar(metricas.salida_bytes, bytes);
+        indicador_fijar(metricas.salida_escrituras, escrituras);
+        indicador_fijar(metricas.salida_esperas, esperas);
+    }
+    if (!metricas_exportar(metricas.archivo)) {
+        printf("No se pudo escribir %s.\n", metricas.archivo);
+    }
+}
+
+// ----------------------------------------------------
+// Almacén de pacientes: crear y liberar handles
+// ----------------------------------------------------
+static int crecer_arreglo(void** arreglo, size_t tam_elemento, int capacidad,
+                          EtiquetaMemoria etiqueta) {
+    void* nuevo = MEM_REALLOC(*arreglo, capacidad * tam_elemento, etiqueta);
+    if (!nuevo) return 0;
+    *arreglo = nuevo;
+    return 1;
+}
+
+// Duplica el almacén y pide de una vez las fichas de los handles nuevos
+static int crecer_almacen() {
+    int nueva = almacen.capacidad ? almacen.capacidad * 2 : 64;
+    Paciente* bloque = MEM_MALLOC((nueva - almacen.capacidad) * sizeof(Paciente), MEM_PACIENTE);
+    if (!bloque ||
+        !crecer_arreglo((void**)&almacen.bloques, sizeof(Paciente*), almacen.num_bloques + 1,
+                        MEM_PACIENTE) ||
+        !crecer_arreglo((void**)&almacen.gravedad, sizeof(int), nueva, MEM_PACIENTE) ||
+        !crecer_arreglo((void**)&almacen.turnos_espera, sizeof(int), nueva, MEM_PACIENTE) ||
+        !crecer_arreglo((void**)&almacen.insumo_req_id, sizeof(int), nueva, MEM_PACIENTE) ||
+        !crecer_arreglo((void**)&almacen.cantidad_req, sizeof(int), nueva, MEM_PACIENTE) ||
+        !crecer_arreglo((void**)&almacen.sala, sizeof(int), nueva, MEM_PACIENTE) ||
+        !crecer_arreglo((void**)&almacen.pos_sala, sizeof(int), nueva, MEM_PACIENTE) ||
+        !crecer_arreglo((void**)&almacen.fichas, sizeof(Paciente*), nueva, MEM_PACIENTE) ||
+        !crecer_arreglo((void**)&almacen.libres, sizeof(int), nueva, MEM_PACIENTE)) {
+        MEM_FREE(bloque);
+        return 0;
+    }
+    almacen.bloques[almacen.num_bloques++] = bloque;
+    for (int h = almacen.capacidad; h < nueva; h++) {
+        almacen.fichas[h] = &bloque[h - almacen.capacidad];
+    }
+    almacen.capacidad = nueva;
+    return 1;
+}
+
+// Asegura que los próximos n pacientes se creen sin pedir memoria: las
+// llegadas de un día se reservan juntas. Devuelve 0 si no hay memoria.
+int reservar_pacientes(int n) {
+    while (almacen.num_libres + almacen.capacidad - almacen.usados < n) {
+        if (!crecer_almacen()) return 0;
+    }
+    return 1;
+}
+
+// Devuelve el handle de un paciente nuevo (campos calientes en cero y sin
+// sala) o -1 si no hay memoria
+int crear_paciente() {
+    int h;
+    if (almacen.num_libres > 0) {
+        h = almacen.libres[--almacen.num_libres];
+    } else {
+        if (almacen.usados == almacen.capacidad && !crecer_almacen()) return -1;
+        h = almacen.usados++;
+    }
+
+    int vivos = almacen.usados - almacen.num_libres;
+    if (vivos > almacen.maximo_vivos) almacen.maximo_vivos = vivos;
+    almacen.fichas[h]->handle = h;
+    almacen.gravedad[h] = 0;
+    almacen.turnos_espera[h] = 0;
+    almacen.insumo_req_id[h] = 0;
+    almacen.cantidad_req[h] = 0;
+    almacen.sala[h] = -1;
+    almacen.pos_sala[h] = -1;
+    return h;
+}
+
+// La ficha queda en su bloque para el próximo paciente con este handle
+void liberar_paciente(int h) {
+    almacen.sala[h] = -1;
+    almacen.pos_sala[h] = -1;
+    almacen.libres[almacen.num_libres++] = h;
+}
+
+Paciente* ficha_paciente(int h) {
+    return almacen.fichas[h];
+}
+
 // ----------------------------------------------------
 // Leer pacientes desde CSV
 // ----------------------------------------------------
@@ -120,37 +633,219 @@ List* leer_pacientes(FILE* archivo) {
     fgets(linea, sizeof(linea), archivo); // Saltar encabezado
 
     while (fgets(linea, sizeof(linea), archivo)) {
-        Paciente* p = (Paciente*) malloc(sizeof(Paciente));
-        if (!p) {
-            continue; // Si falla, saltar a la siguiente línea
-        }
+        Paciente leido;
+        char area[50] = "";
+        int gravedad = 0, insumo_req_id = 0, cantidad_req = 0;
 
         sscanf(linea,
             "%d,%49[^,],%49[^,],%d,%49[^,],%99[^,],%d,%d,%d",
-            &p->id,
-            p->nombre,
-            p->apellido,
-            &p->edad,
-            p->area,
-            p->diagnostico,
-            &p->gravedad,
-            &p->insumo_req_id,
-            &p->cantidad_req);
+            &leido.id,
+            leido.nombre,
+            leido.apellido,
+            &leido.edad,
+            area,
+            leido.diagnostico,
+            &gravedad,
+            &insumo_req_id,
+            &cantidad_req);
         
-        if (p->gravedad < 1 || p->gravedad > 3 ||
-        p->edad < 0 || p->edad > 120 ||
-        p->cantidad_req < 0) {
-            free(p);
+        if (gravedad < 1 || gravedad > 3 ||
+        leido.edad < 0 || leido.edad > 120 ||
+        cantidad_req < 0) {
             continue;
         }
 
-        p->turnos_espera = 0;
+        int h = crear_paciente();
+        if (h < 0) {
+            continue; // Si falla, saltar a la siguiente línea
+        }
+        Paciente* p = ficha_paciente(h);
+        leido.handle = h;
+        leido.area = simbolo(area);
+        leido.sala_area = -1;
+        *p = leido;
+        almacen.gravedad[h] = gravedad;
+        almacen.insumo_req_id[h] = insumo_req_id;
+        almacen.cantidad_req[h] = cantidad_req;
         list_pushBack(lista_pacientes, p);
     }
 
     return lista_pacientes;
 }
 
+// ----------------------------------------------------
+// Catálogo de insumos: una ficha por ID, compartida por todas las salas
+// ----------------------------------------------------
+Insumo* insumo_por_id(int id) {
+    MapPair* par = hashmap_search(catalogo.por_id, &id);
+    return par ? par->value : NULL;
+}
+
+// Agrega una copia de los datos al catálogo y la devuelve. Si el ID ya
+// existe devuelve la ficha existente sin modificarla.
+Insumo* registrar_insumo(Insumo* datos) {
+    if (!catalogo.por_id) catalogo.por_id = hashmap_create(hash_int, is_equal_int);
+    Insumo* existente = insumo_por_id(datos->id);
+    if (existente) return existente;
+
+    if (catalogo.cantidad == catalogo.capacidad) {
+        int nueva = catalogo.capacidad ? catalogo.capacidad * 2 : 16;
+        if (!crecer_arreglo((void**)&catalogo.insumos, sizeof(Insumo*), nueva, MEM_INSUMO) ||
+            !crecer_arreglo((void**)&catalogo.demanda, sizeof(DemandaInsumo), nueva, MEM_INSUMO)) return NULL;
+        catalogo.capacidad = nueva;
+    }
+    Insumo* ins = MEM_MALLOC(sizeof(Insumo), MEM_INSUMO);
+    if (!ins) return NULL;
+    *ins = *datos;
+    ins->indice = catalogo.cantidad;
+    memset(&catalogo.demanda[catalogo.cantidad], 0, sizeof(DemandaInsumo));
+    catalogo.insumos[catalogo.cantidad++] = ins;
+    hashmap_insert(catalogo.por_id, &ins->id, ins);
+    return ins;
+}
+
+Insumo* ficha_insumo(Existencia* e) {
+    return catalogo.insumos[e->catalogo];
+}
+
+DemandaInsumo* demanda_insumo(Existencia* e) {
+    return &catalogo.demanda[e->catalogo];
+}
+
+// ----------------------------------------------------
+// Lotes: fechas como número de día y consumo FEFO (primero en vencer,
+// primero en salir)
+// ----------------------------------------------------
+static int dia_desde_civil(int anio, int mes, int dia) {
+    anio -= mes <= 2;
+    int era = (anio >= 0 ? anio : anio - 399) / 400;
+    int anio_era = anio - era * 400;
+    int dia_anio = (153 * (mes + (mes > 2 ? -3 : 9)) + 2) / 5 + dia - 1;
+    int dia_era = anio_era * 365 + anio_era / 4 - anio_era / 100 + dia_anio;
+    return era * 146097 + dia_era - 719468;
+}
+
+static void civil_desde_dia(int n, int* anio, int* mes, int* dia) {
+    int z = n + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int dia_era = z - era * 146097;
+    int anio_era = (dia_era - dia_era / 1460 + dia_era / 36524 - dia_era / 146096) / 365;
+    int dia_anio = dia_era - (365 * anio_era + anio_era / 4 - anio_era / 100);
+    int mp = (5 * dia_anio + 2) / 153;
+    *dia = dia_anio - (153 * mp + 2) / 5 + 1;
+    *mes = mp < 10 ? mp + 3 : mp - 9;
+    *anio = anio_era + era * 400 + (*mes <= 2);
+}
+
+// Convierte "YYYY-MM-DD" a número de día. Vacío, "-", "N/A" o una fecha
+// inválida se toman como SIN_VENCIMIENTO.
+int dia_desde_fecha(const char* fecha) {
+    int anio, mes, dia;
+    if (!fecha || sscanf(fecha, "%d-%d-%d", &anio, &mes, &dia) != 3) return SIN_VENCIMIENTO;
+    if (mes < 1 || mes > 12 || dia < 1 || dia > 31) return SIN_VENCIMIENTO;
+
+    // Fechas como 2025-02-30 no vuelven a ser la misma al convertirlas
+    int n = dia_desde_civil(anio, mes, dia);
+    int a, m, d;
+    civil_desde_dia(n, &a, &m, &d);
+    return (a == anio && m == mes && d == dia) ? n : SIN_VENCIMIENTO;
+}
+
+// Escribe el día como "YYYY-MM-DD" (o "N/A") en fecha, de al menos 20 bytes
+void fecha_desde_dia(int dia, char* fecha) {
+    if (dia == SIN_VENCIMIENTO) {
+        strcpy(fecha, "N/A");
+        return;
+    }
+    int a, m, d;
+    civil_desde_dia(dia, &a, &m, &d);
+    snprintf(fecha, 20, "%04d-%02d-%02d", a, (unsigned char)m, (unsigned char)d);
+}
+
+// Fecha del día de simulación actual
+int fecha_hoy() {
+    static int inicio = -1;
+    if (inicio < 0) inicio = dia_desde_fecha(FECHA_INICIO_SIMULACION);
+    return inicio + dia_actual;
+}
+
+// Vida útil de los lotes nuevos de un insumo, según el primer vencimiento
+// conocido
+static int vida_util_desde(int vence) {
+    if (vence == SIN_VENCIMIENTO) return SIN_VENCIMIENTO;
+    int dias = vence - fecha_hoy();
+    return dias < VIDA_UTIL_MINIMA ? VIDA_UTIL_MINIMA : dias;
+}
+
+// Vencimiento de un lote que llega hoy del proveedor
+int vence_reposicion(Insumo* ins) {
+    if (ins->vida_util == SIN_VENCIMIENTO) return SIN_VENCIMIENTO;
+    return fecha_hoy() + ins->vida_util;
+}
+
+// La próxima vista vuelve a copiar la sala de la existencia
+static void marcar_existencia(Existencia* e) {
+    salas_global->salas[e->sala].cambiada = 1;
+}
+
+// O(log lotes)
+void agregar_lote(Existencia* e, int vence, int cantidad) {
+    if (cantidad <= 0) return;
+    marcar_existencia(e);
+    Lote* l = MEM_MALLOC(sizeof(Lote), MEM_LOTE);
+    if (!l) return;
+    l->vence = vence;
+    l->cantidad = cantidad;
+    heap_push(e->lotes, l, -vence);
+    e->cantidad += cantidad;
+    demanda_insumo(e)->stock += cantidad;
+}
+
+// Saca hasta cantidad unidades empezando por el lote que vence primero y
+// devuelve cuántas sacó. Si destino no es NULL las unidades pasan a sus lotes
+// con el mismo vencimiento. Cada lote agotado cuesta O(log lotes).
+int consumir_lotes(Existencia* e, int cantidad, Existencia* destino) {
+    int sacadas = 0;
+    marcar_existencia(e);
+    while (sacadas < cantidad) {
+        Lote* l = heap_top(e->lotes);
+        if (!l) break;
+        int toma = cantidad - sacadas;
+        if (toma > l->cantidad) toma = l->cantidad;
+        if (destino) agregar_lote(destino, l->vence, toma);
+        l->cantidad -= toma;
+        sacadas += toma;
+        if (l->cantidad == 0) {
+            heap_pop(e->lotes);
+            MEM_FREE(l);
+        }
+    }
+    e->cantidad -= sacadas;
+    demanda_insumo(e)->stock -= sacadas; // si van a destino, agregar_lote las vuelve a sumar
+    return sacadas;
+}
+
+// Retira los lotes vencidos a la fecha hoy (inclusive) y devuelve cuántas
+// unidades se perdieron. Sólo se miran los lotes que vencen, no todo el stock.
+int purgar_vencidos(Existencia* e, int hoy) {
+    int vencidas = 0;
+    Lote* l;
+    marcar_existencia(e);
+    while ((l = heap_top(e->lotes)) != NULL && l->vence <= hoy) {
+        vencidas += l->cantidad;
+        heap_pop(e->lotes);
+        MEM_FREE(l);
+    }
+    e->cantidad -= vencidas;
+    demanda_insumo(e)->stock -= vencidas;
+    return vencidas;
+}
+
+int proximo_vencimiento(Existencia* e) {
+    Lote* l = heap_top(e->lotes);
+    return l ? l->vence : SIN_VENCIMIENTO;
+}
+
 // ----------------------------------------------------
 // Leer insumos desde CSV
 // ----------------------------------------------------
@@ -171,279 +866,1172 @@ List* leer_insumos(FILE* archivo) {
     while (fgets(linea, sizeof(linea), archivo)) {
 
         size_t len = strlen(linea);
-        if (len > 0 && linea[len - 1] == '\n') {
+        if (len > 0 && linea[len - 1] != '\n' && !feof(archivo)) {
             int ch;
             while ((ch = fgetc(archivo)) != '\n' && ch != EOF); // Consumir el resto de la línea
         }
 
         linea[strcspn(linea, "\r\n")] = '\0'; // Eliminar salto de línea
 
-        Insumo* ins = malloc(sizeof(Insumo));
-        if (ins == NULL) continue;
-
+        Insumo datos;
+        int cantidad;
+        char tipo[50], unidad[30], fecha[20], ubicacion[50];
         int leidos = sscanf(linea, "%d,%99[^,],%49[^,],%d,%29[^,],%19[^,],%49[^\n]",
-                &ins->id, 
-                ins->nombre, 
-                ins->tipo, 
-                &ins->cantidad,
-                ins->unidad, 
-                ins->fecha_vencimiento, 
-                ins->ubicacion);
-
-        if (leidos != CAMPOS_ESPERADOS || ins->cantidad < 0) {
-            free(ins);
+                &datos.id, 
+                datos.nombre, 
+                tipo, 
+                &cantidad,
+                unidad, 
+                fecha, 
+                ubicacion);
+
+        if (leidos != CAMPOS_ESPERADOS || cantidad < 0) {
             continue; // Si no se leyeron todos los campos o cantidad es negativa, saltar
         }
+        datos.tipo = simbolo(tipo);
+        datos.unidad = simbolo(unidad);
+        int vence = dia_desde_fecha(fecha); // cada fila es un lote
+        datos.vida_util = vida_util_desde(vence);
+
+        // Si el ID ya estaba en el catálogo se conservan sus datos
+        Insumo* ins = registrar_insumo(&datos);
+        CargaInsumo* carga = MEM_MALLOC(sizeof(CargaInsumo), MEM_STOCK);
+        if (ins == NULL || carga == NULL) {
+            MEM_FREE(carga);
+            continue;
+        }
+        carga->catalogo = ins->indice;
+        carga->cantidad = cantidad;
+        carga->vence = vence;
+        carga->ubicacion = simbolo(ubicacion);
 
-        list_pushBack(lista_insumos, ins);
+        list_pushBack(lista_insumos, carga);
     }
 
     return lista_insumos;
 }
 
 // ----------------------------------------------------
-// Crear y configurar salas
+// Leer los tratamientos por gravedad desde CSV (después de los insumos)
 // ----------------------------------------------------
-Sala* crear_sala(const char* nombre, int cap_pacientes, int cap_insumos) {
-    Sala* s = malloc(sizeof(Sala));
-    if (!s) return NULL;
-
-    strncpy(s->nombre, nombre, 50);
-    s->capacidad_pacientes = cap_pacientes;
-    s->capacidad_insumos = cap_insumos;
-    s->pacientes = list_create();
-    s->insumos = list_create();
-    s->stock_diario = NULL;  // sólo válido si es Bodega Central
-    return s;
-}
-
-List* inicializar_salas() {
-    List* salas = list_create();
-
-    // Sala de Espera (capacidad muy grande, sin insumos)
-    list_pushBack(salas, crear_sala("Sala de Espera", 999, 0));
-
-    // Salas clínicas
-    list_pushBack(salas, crear_sala("UCI", 10, 100));
-    list_pushBack(salas, crear_sala("Urgencias", 20, 150));
-    list_pushBack(salas, crear_sala("Ginecologia", 8, 80));
-    list_pushBack(salas, crear_sala("Traumatologia", 12, 120));
-    list_pushBack(salas, crear_sala("Medicina Interna", 15, 100));
-    list_pushBack(salas, crear_sala("Pediatria", 10, 90));
-
-    // Bodega Central (capacidad pacientes=0, insumos se cargan dinámicamente)
-    Sala* bodega = crear_sala("Bodega Central", 0, 200);
-    bodega->stock_diario = list_create();
-    list_pushBack(salas, bodega);
+// Una fila por gravedad: gravedad,insumo_id,cantidad. Devuelve cuántas de
+// las tres gravedades quedaron con tratamiento; avisa de las que faltan.
+int leer_tratamientos(FILE* archivo) {
+    memset(tratamientos, 0, sizeof(tratamientos));
+    char linea[MAX_LINEA];
+    if (fgets(linea, sizeof(linea), archivo) == NULL) linea[0] = '\0'; // Saltar encabezado
 
-    return salas;
-}
+    while (fgets(linea, sizeof(linea), archivo)) {
+        int gravedad, insumo_id, cantidad;
+        if (sscanf(linea, "%d,%d,%d", &gravedad, &insumo_id, &cantidad) != 3 ||
+            gravedad < 1 || gravedad > 3 || cantidad <= 0) {
+            continue;
+        }
+        if (!insumo_por_id(insumo_id)) {
+            printf("Tratamiento de gravedad %d ignorado: el insumo %d no esta en el catalogo.\n",
+                   gravedad, insumo_id);
+            continue;
+        }
+        tratamientos[gravedad].insumo_id = insumo_id;
+        tratamientos[gravedad].cantidad = cantidad;
+    }
 
-Sala* buscar_sala(List* salas, const char* nombre) {
-    Sala* s = list_first(salas);
-    while (s != NULL) {
-        if (strcmp(s->nombre, nombre) == 0) return s;
-        s = list_next(salas);
+    int configuradas = 0;
+    for (int g = 1; g <= 3; g++) {
+        if (tratamientos[g].insumo_id) configuradas++;
+        else printf("tratamientos.csv no define el insumo para gravedad %d: los "
+                    "pacientes nuevos de esa gravedad no se podran curar.\n", g);
     }
-    return NULL;
+    return configuradas;
 }
 
 // ----------------------------------------------------
-// Asignar todos los pacientes iniciales a Sala de Espera
+// Leer la configuración de salas desde CSV
 // ----------------------------------------------------
-void asignar_pacientes_a_espera(List* pacientes, List* salas) {
-    Sala* espera = buscar_sala(salas, "Sala de Espera");
-    if (!espera) return;
+static int comparar_prioridad_critica(const void* a, const void* b) {
+    const Sala* x = *(Sala* const*)a;
+    const Sala* y = *(Sala* const*)b;
+    if (x->prioridad_critica != y->prioridad_critica)
+        return x->prioridad_critica - y->prioridad_critica;
+    return x->id - y->id;
+}
 
-    Paciente* p = list_first(pacientes);
-    while (p != NULL) {
-        list_pushBack(espera->pacientes, p);
-        p = list_next(pacientes);
+// Libera una tabla que no se terminó de cargar (sus salas aún no tienen
+// pacientes ni insumos)
+static void liberar_tabla_salas(TablaSalas* tabla) {
+    for (int id = 0; id < tabla->cantidad; id++) {
+        Sala* s = &tabla->salas[id];
+        hashmap_destroy(s->indice_insumos);
+        hashmap_destroy(s->indice_stock);
+        if (s->stock_diario) {
+            list_clean(s->stock_diario);
+            MEM_FREE(s->stock_diario);
+        }
     }
+    hashmap_destroy(tabla->por_nombre);
+    hashmap_destroy(tabla->por_simbolo);
+    MEM_FREE(tabla->salas);
+    MEM_FREE(tabla->clinicas);
+    MEM_FREE(tabla->criticas);
+    MEM_FREE(tabla);
 }
 
-// ----------------------------------------------------
-// Asignar insumos iniciales a las salas (incluida Bodega)
-// ----------------------------------------------------
-void asignar_insumos_a_salas(List* insumos, List* salas) {
-    Insumo* i = list_first(insumos);
-    while (i != NULL) {
-        Sala* sala = buscar_sala(salas, i->ubicacion);
-        if (sala == NULL) {
-            printf("Sala '%s' no existe. No se asigno insumo ID %d (%s).\n", i->ubicacion, i->id, i->nombre);
-        } else {
-            // Si es Bodega, además creamos StockDiario
-            if (strcmp(sala->nombre, "Bodega Central") == 0) {
-                // Insertar Insumo en Bodega
-                list_pushBack(sala->insumos, i);
-                // Crear StockDiario
-                StockDiario* sd = malloc(sizeof(StockDiario));
-                sd->id_insumo = i->id;
-                sd->cantidad_total = i->cantidad;
-                sd->retirado_hoy = 0;
-                list_pushBack(sala->stock_diario, sd);
-            } else {
-                // Insertar Insumo en sala clínica
-                list_pushBack(sala->insumos, i);
+// Devuelve NULL si no hay memoria para la tabla
+TablaSalas* leer_salas(FILE* archivo) {
+    TablaSalas* tabla = MEM_MALLOC(sizeof(TablaSalas), MEM_SALA);
+    if (!tabla) return NULL;
+
+    int capacidad = 16;
+    tabla->salas = MEM_MALLOC(capacidad * sizeof(Sala), MEM_SALA);
+    if (!tabla->salas) {
+        MEM_FREE(tabla);
+        return NULL;
+    }
+    tabla->cantidad = 0;
+    tabla->por_nombre = hashmap_create(hash_string, is_equal_string);
+    tabla->por_simbolo = hashmap_create(hash_int, is_equal_int);
+    tabla->id_espera = -1;
+    tabla->id_bodega = -1;
+    tabla->clinicas = NULL;
+    tabla->num_clinicas = 0;
+    tabla->criticas = NULL;
+    tabla->num_criticas = 0;
+
+    char** campos = leer_linea_csv(archivo, ','); // Saltar encabezado
+    while (campos != NULL && (campos = leer_linea_csv(archivo, ',')) != NULL) {
+        int n = 0;
+        while (campos[n] != NULL) n++;
+        if (n < 5 || campos[0][0] == '\0') continue;
+
+        int cap_pacientes = atoi(campos[2]);
+        int cap_insumos = atoi(campos[3]);
+        if (cap_pacientes < 0 || cap_insumos < 0) continue;
+
+        int tipo = SALA_CLINICA;
+        if (atoi(campos[4]) == 1) tipo = SALA_BODEGA;
+        else if (strcmp(campos[1], "Espera") == 0) tipo = SALA_ESPERA;
+
+        if ((tipo == SALA_ESPERA && tabla->id_espera >= 0) ||
+            (tipo == SALA_BODEGA && tabla->id_bodega >= 0)) {
+            printf("Sala '%s' ignorada: solo puede haber una %s.\n", campos[0],
+                   tipo == SALA_ESPERA ? "Sala de Espera" : "Bodega");
+            continue;
+        }
+
+        if (tabla->cantidad == capacidad) {
+            capacidad *= 2;
+            Sala* nuevas = MEM_REALLOC(tabla->salas, capacidad * sizeof(Sala), MEM_SALA);
+            if (!nuevas) {
+                liberar_tabla_salas(tabla);
+                return NULL;
             }
+            tabla->salas = nuevas;
+        }
+        int id = tabla->cantidad;
+        inicializar_sala(&tabla->salas[id], id, campos[0], tipo, cap_pacientes, cap_insumos);
+        // La columna criticos es opcional; sólo cuenta en las salas clínicas
+        if (tipo == SALA_CLINICA && n > 5 && atoi(campos[5]) > 0)
+            tabla->salas[id].prioridad_critica = atoi(campos[5]);
+        tabla->cantidad++;
+        if (tipo == SALA_ESPERA) tabla->id_espera = id;
+        if (tipo == SALA_BODEGA) tabla->id_bodega = id;
+    }
+
+    // Los índices se arman al final: la tabla ya no se mueve en memoria
+    tabla->clinicas = MEM_MALLOC((tabla->cantidad + 1) * sizeof(int), MEM_SALA);
+    if (!tabla->clinicas) {
+        liberar_tabla_salas(tabla);
+        return NULL;
+    }
+    for (int id = 0; id < tabla->cantidad; id++) {
+        Sala* s = &tabla->salas[id];
+        if (hashmap_search(tabla->por_nombre, s->nombre)) {
+            printf("Sala '%s' repetida en la configuracion.\n", s->nombre);
+            continue;
         }
-        i = list_next(insumos);
+        hashmap_insert(tabla->por_nombre, s->nombre, s);
+        hashmap_insert(tabla->por_simbolo, &s->simbolo, s);
+        if (s->tipo == SALA_CLINICA) tabla->clinicas[tabla->num_clinicas++] = id;
+    }
+
+    // Salas para gravedad 3, por prioridad y, a igual prioridad, por ID
+    Sala** orden = MEM_MALLOC((tabla->cantidad + 1) * sizeof(Sala*), MEM_SALA);
+    tabla->criticas = MEM_MALLOC((tabla->cantidad + 1) * sizeof(int), MEM_SALA);
+    if (!orden || !tabla->criticas) {
+        MEM_FREE(orden);
+        liberar_tabla_salas(tabla);
+        return NULL;
+    }
+    int n_orden = 0;
+    for (int k = 0; k < tabla->num_clinicas; k++) {
+        Sala* s = &tabla->salas[tabla->clinicas[k]];
+        if (s->prioridad_critica > 0) orden[n_orden++] = s;
     }
+    qsort(orden, n_orden, sizeof(Sala*), comparar_prioridad_critica);
+    for (int k = 0; k < n_orden; k++)
+        tabla->criticas[tabla->num_criticas++] = orden[k]->id;
+    MEM_FREE(orden);
+    if (tabla->num_criticas == 0) {
+        printf("Ninguna sala clinica tiene la columna criticos en salas.csv: los "
+               "pacientes de gravedad 3 no se transferiran solos desde la Sala de Espera.\n");
+    }
+
+    return tabla;
 }
 
 // ----------------------------------------------------
-// Mostrar estado de todas las salas
+// Crear y configurar salas
 // ----------------------------------------------------
-void mostrar_salas(List* salas) {
-    Sala* s = list_first(salas);
-    while (s != NULL) {
-        printf("\nSala: %s\n", s->nombre);
-        printf("Capacidad: %d pacientes, %d insumos\n", s->capacidad_pacientes, s->capacidad_insumos);
-        printf("Ocupado:   %d pacientes, %d insumos\n",
-               list_size(s->pacientes), list_size(s->insumos));
+void inicializar_sala(Sala* s, int id, const char* nombre, int tipo,
+                      int cap_pacientes, int cap_insumos) {
+    s->id = id;
+    strncpy(s->nombre, nombre, sizeof(s->nombre) - 1);
+    s->nombre[sizeof(s->nombre) - 1] = '\0';
+    s->simbolo = simbolo(s->nombre);
+    s->tipo = tipo;
+    s->capacidad_pacientes = cap_pacientes;
+    s->capacidad_insumos = cap_insumos;
+    s->pacientes = NULL;
+    s->num_pacientes = 0;
+    s->cap_pacientes = 0;
+    s->insumos = NULL;
+    s->num_insumos = 0;
+    s->cap_insumos = 0;
+    s->indice_insumos = hashmap_create(hash_int, is_equal_int);
+    // Stock diario sólo para la Bodega
+    s->stock_diario = (tipo == SALA_BODEGA) ? list_create() : NULL;
+    s->indice_stock = (tipo == SALA_BODEGA) ? hashmap_create(hash_int, is_equal_int) : NULL;
+    for (int g = 0; g < 4; g++) s->por_gravedad[g] = 0;
+    s->en_peligro = 0;
+    s->prioridad_critica = 0;
+    s->cambiada = 1;
+}
 
-        Paciente* p = list_first(s->pacientes);
-        while (p != NULL) {
-            printf("  Paciente #%d: %s %s (Gravedad: %d) Turnos espera: %d Requiere ID%d x%d\n",
-                   p->id, p->nombre, p->apellido, p->gravedad, p->turnos_espera,
-                   p->insumo_req_id, p->cantidad_req);
-            p = list_next(s->pacientes);
-        }
+Sala* sala_por_id(TablaSalas* salas, int id) {
+    if (!salas || id < 0 || id >= salas->cantidad) return NULL;
+    return &salas->salas[id];
+}
 
-        Insumo* i = list_first(s->insumos);
-        while (i != NULL) {
-            printf("  Insumo: %s (ID %d, %d %s) Vence: %s\n",
-                   i->nombre, i->id, i->cantidad, i->unidad,
-                   i->fecha_vencimiento[0] ? i->fecha_vencimiento : "N/A");
-            i = list_next(s->insumos);
-        }
+Sala* sala_espera(TablaSalas* salas) {
+    return sala_por_id(salas, salas->id_espera);
+}
 
-        s = list_next(salas);
+Sala* sala_bodega(TablaSalas* salas) {
+    return sala_por_id(salas, salas->id_bodega);
+}
+
+// Primera sala para gravedad 3 con cupo, en orden de preferencia. *desde
+// guarda la posición en salas->criticas de la primera que no se sabe llena:
+// durante un barrido las salas sólo se llenan, así que no se revisan de nuevo.
+Sala* sala_critica_con_cupo(TablaSalas* salas, int* desde) {
+    while (*desde < salas->num_criticas) {
+        Sala* s = &salas->salas[salas->criticas[*desde]];
+        if (s->num_pacientes < s->capacidad_pacientes) return s;
+        (*desde)++;
     }
+    return NULL;
+}
+
+Sala* buscar_sala(TablaSalas* salas, const char* nombre) {
+    MapPair* par = hashmap_search(salas->por_nombre, (void*)nombre);
+    return par ? par->value : NULL;
+}
+
+Sala* buscar_sala_simbolo(TablaSalas* salas, Simbolo nombre) {
+    MapPair* par = hashmap_search(salas->por_simbolo, &nombre);
+    return par ? par->value : NULL;
 }
 
 // ----------------------------------------------------
-// Transferencia manual de varios pacientes (max 5 por turno)
+// Índices por ID de insumos (todas las salas) y stock (Bodega)
 // ----------------------------------------------------
-void transferir_pacientes_menu(List* salas) {
-    Sala* espera = buscar_sala(salas, "Sala de Espera");
-    if (!espera || list_size(espera->pacientes) == 0) {
-        printf("No hay pacientes en Sala de Espera.\n");
-        return;
-    }
+Existencia* buscar_insumo(Sala* sala, int id) {
+    MapPair* par = hashmap_search(sala->indice_insumos, &id);
+    return par ? par->value : NULL;
+}
 
-    int acciones_restantes = 5;
-    int pagina = 1;
-    int total = list_size(espera->pacientes);
-    int por_pagina = 10;
-    int max_paginas = (total + por_pagina - 1) / por_pagina;
-    int opcion;
-    while (acciones_restantes > 0 && total > 0) {
-        printf("\nPacientes en Sala de Espera (pag %d/%d). Acciones restantes: %d\n",
-               pagina, max_paginas, acciones_restantes);
+// Las claves del índice apuntan al ID en el catálogo (no se mueve); el valor
+// se corrige cuando una existencia cambia de posición en el arreglo
+static void reubicar_existencia(Sala* sala, int pos) {
+    Existencia* e = &sala->insumos[pos];
+    MapPair* par = hashmap_search(sala->indice_insumos, &ficha_insumo(e)->id);
+    if (par) par->value = e;
+}
 
-        // Mostrar la página actual
-        int inicio = (pagina - 1) * por_pagina;
-        for (int i = 0; i < inicio; i++) {
-            list_first(espera->pacientes);
-            for (int j = 0; j < i; j++) list_next(espera->pacientes);
-        }
-        Paciente* p = NULL;
-        for (int i = 0; i < por_pagina && inicio + i < total; i++) {
-            if (i == 0) p = list_first(espera->pacientes);
-            else p = list_next(espera->pacientes);
-            printf("%2d) ID %d - %s %s - Gravedad %d - Turnos %d\n",
-                   i + 1, p->id, p->nombre, p->apellido, p->gravedad, p->turnos_espera);
-        }
+StockDiario* buscar_stock(Sala* bodega, int id) {
+    MapPair* par = hashmap_search(bodega->indice_stock, &id);
+    return par ? par->value : NULL;
+}
 
-        printf("\n[1-%d] Transferir paciente  [P]ag sig  [A]nterior  [0] Salir: ", por_pagina);
-        char input[10];
-        fgets(input, sizeof(input), stdin);
+// Devuelve la existencia del insumo en la sala, creándola vacía si no la tenía
+Existencia* existencia_sala(Sala* sala, Insumo* ins) {
+    Existencia* e = buscar_insumo(sala, ins->id);
+    if (e) return e;
 
-        if (input[0] == 'P' || input[0] == 'p') {
-            if (pagina < max_paginas) pagina++;
-            else printf("Ya estas en la ultima pagina.\n");
-            continue;
+    Heap* lotes = heap_create();
+    if (!lotes) return NULL;
+
+    if (sala->num_insumos == sala->cap_insumos) {
+        int nueva = sala->cap_insumos ? sala->cap_insumos * 2 : 8;
+        Existencia* antes = sala->insumos;
+        if (!crecer_arreglo((void**)&sala->insumos, sizeof(Existencia), nueva, MEM_SALA)) {
+            heap_destroy(lotes);
+            return NULL;
         }
-        if (input[0] == 'A' || input[0] == 'a') {
-            if (pagina > 1) pagina--;
-            else printf("Ya estas en la primera pagina.\n");
-            continue;
+        sala->cap_insumos = nueva;
+        if (sala->insumos != antes) {
+            for (int k = 0; k < sala->num_insumos; k++) reubicar_existencia(sala, k);
         }
+    }
+    e = &sala->insumos[sala->num_insumos++];
+    e->catalogo = ins->indice;
+    e->sala = sala->id;
+    e->cantidad = 0;
+    sala->cambiada = 1;
+    e->lotes = lotes;
+    hashmap_insert(sala->indice_insumos, &ins->id, e);
+    return e;
+}
 
-        opcion = atoi(input);
-        if (opcion == 0) break;
-        if (opcion < 1 || opcion > por_pagina || inicio + opcion > total) {
-            printf("Opcion invalida.\n");
-            continue;
-        }
+// Suma a la sala un lote del insumo
+Existencia* agregar_insumo_sala(Sala* sala, Insumo* ins, int cantidad, int vence) {
+    Existencia* e = existencia_sala(sala, ins);
+    if (e) agregar_lote(e, vence, cantidad);
+    return e;
+}
 
-        // Identificar al paciente
-        p = list_first(espera->pacientes);
-        for (int k = 0; k < inicio + (opcion - 1); k++) {
-            p = list_next(espera->pacientes);
-        }
+void agregar_stock_bodega(Sala* bodega, StockDiario* sd) {
+    list_pushBack(bodega->stock_diario, sd);
+    hashmap_insert(bodega->indice_stock, &sd->id_insumo, sd);
+}
 
-        // Transferir paciente individual
-        transferir_paciente_unico(salas, p);
-        acciones_restantes--;
-        total--;
-        max_paginas = (total + por_pagina - 1) / por_pagina;
-        if (pagina > max_paginas) pagina = max_paginas;
-    }
+// Devuelve el StockDiario del insumo en Bodega, creándolo (junto con su
+// existencia vacía) si no estaba
+StockDiario* stock_bodega(Sala* bodega, Insumo* ins) {
+    StockDiario* sd = buscar_stock(bodega, ins->id);
+    if (sd) return sd;
+    Existencia* e = existencia_sala(bodega, ins);
+    sd = e ? MEM_MALLOC(sizeof(StockDiario), MEM_STOCK) : NULL;
+    if (!sd) return NULL;
+    sd->id_insumo = ins->id;
+    sd->cantidad_total = e->cantidad;
+    sd->retirado_hoy = 0;
+    agregar_stock_bodega(bodega, sd);
+    return sd;
+}
 
-    if (acciones_restantes == 0) {
-        printf("Has agotado tus acciones de transferencia para este turno.\n");
+// La última existencia ocupa el lugar de la quitada
+void quitar_insumo_sala(Sala* sala, Existencia* e) {
+    MEM_FREE(hashmap_remove(sala->indice_insumos, &ficha_insumo(e)->id));
+    Lote* l;
+    while ((l = heap_top(e->lotes)) != NULL) {
+        heap_pop(e->lotes);
+        MEM_FREE(l);
+    }
+    heap_destroy(e->lotes);
+    int pos = (int)(e - sala->insumos);
+    sala->num_insumos--;
+    sala->cambiada = 1;
+    if (pos != sala->num_insumos) {
+        sala->insumos[pos] = sala->insumos[sala->num_insumos];
+        reubicar_existencia(sala, pos);
     }
 }
 
 // ----------------------------------------------------
-// Transferir un solo paciente (subfunción de arriba)
+// Índices secundarios: se actualizan al admitir y dar de alta (cura o muerte)
 // ----------------------------------------------------
-void transferir_paciente_unico(List* salas, Paciente* p) {
-    if (!p) return;
-    Sala* espera = buscar_sala(salas, "Sala de Espera");
-    if (!espera) return;
+static int clave_turnos(int turnos) {
+    return turnos > MAX_TURNOS_INDICE ? MAX_TURNOS_INDICE : turnos;
+}
 
-    printf("\nTransferir Paciente ID %d (%s %s, Gravedad %d):\n",
-           p->id, p->nombre, p->apellido, p->gravedad);
+static GrupoIndice* grupo_indice(HashMap* indice, int clave) {
+    MapPair* par = hashmap_search(indice, &clave);
+    return par ? par->value : NULL;
+}
 
-    int idx = 1;
-    Sala* destino_preferido = buscar_sala(salas, p->area);
-    if (destino_preferido &&
-        list_size(destino_preferido->pacientes) < destino_preferido->capacidad_pacientes) {
-        printf("%d) %s (ocupado: %d/%d)\n", idx,
-               destino_preferido->nombre,
-               list_size(destino_preferido->pacientes),
-               destino_preferido->capacidad_pacientes);
-        idx++;
-    } else {
-        destino_preferido = NULL;
+static void indice_agregar(HashMap* indice, int clave, Paciente* p) {
+    GrupoIndice* g = grupo_indice(indice, clave);
+    if (!g) {
+        g = MEM_MALLOC(sizeof(GrupoIndice), MEM_INDICE);
+        if (!g) return;
+        g->clave = clave;
+        g->pacientes = hashmap_create(hash_int, is_equal_int);
+        hashmap_insert(indice, &g->clave, g);
+    }
+    hashmap_insert(g->pacientes, &p->id, p);
+}
+
+static void indice_quitar(HashMap* indice, int clave, Paciente* p) {
+    GrupoIndice* g = grupo_indice(indice, clave);
+    if (g) MEM_FREE(hashmap_remove(g->pacientes, &p->id));
+}
+
+static int indice_contar(HashMap* indice, int clave) {
+    GrupoIndice* g = grupo_indice(indice, clave);
+    return g ? hashmap_size(g->pacientes) : 0;
+}
+
+// Handle del paciente vivo con ese ID o -1; todo paciente vivo está en uno de
+// los tres grupos de gravedad
+int buscar_paciente(int id) {
+    for (int gravedad = 1; gravedad <= 3; gravedad++) {
+        GrupoIndice* g = grupo_indice(indices.por_gravedad, gravedad);
+        MapPair* par = g ? hashmap_search(g->pacientes, &id) : NULL;
+        if (par) return ((Paciente*)par->value)->handle;
+    }
+    return -1;
+}
+
+void inicializar_indices() {
+    indices.por_gravedad = hashmap_create(hash_int, is_equal_int);
+    indices.por_area = hashmap_create(hash_int, is_equal_int);
+    indices.por_insumo = hashmap_create(hash_int, is_equal_int);
+    indices.por_turnos = hashmap_create(hash_int, is_equal_int);
+    indices.por_texto = trie_create();
+    indices.total = 0;
+}
+
+// Registra (o quita) en el trie cada sufijo del texto que empieza en una
+// palabra, así un prefijo encuentra "Fractura de femur" tanto por "frac"
+// como por "femur" o "de fe"
+static void indexar_texto(const char* texto, Paciente* p, int agregar) {
+    for (const char* c = texto; *c; c++) {
+        if (*c == ' ' || (c != texto && c[-1] != ' ')) continue;
+        if (agregar) trie_insert(indices.por_texto, c, p);
+        else trie_remove(indices.por_texto, c, p);
+    }
+}
+
+void admitir_paciente(int h) {
+    Paciente* p = ficha_paciente(h);
+    indice_agregar(indices.por_gravedad, almacen.gravedad[h], p);
+    indice_agregar(indices.por_area, p->sala_area, p);
+    indice_agregar(indices.por_insumo, almacen.insumo_req_id[h], p);
+    indice_agregar(indices.por_turnos, clave_turnos(almacen.turnos_espera[h]), p);
+    indexar_texto(p->nombre, p, 1);
+    indexar_texto(p->apellido, p, 1);
+    indexar_texto(p->diagnostico, p, 1);
+    indices.total++;
+}
+
+// Además de quitarlo de los índices, devuelve su handle al almacén
+void dar_alta_paciente(int h) {
+    Paciente* p = ficha_paciente(h);
+    indice_quitar(indices.por_gravedad, almacen.gravedad[h], p);
+    indice_quitar(indices.por_area, p->sala_area, p);
+    indice_quitar(indices.por_insumo, almacen.insumo_req_id[h], p);
+    indice_quitar(indices.por_turnos, clave_turnos(almacen.turnos_espera[h]), p);
+    indexar_texto(p->nombre, p, 0);
+    indexar_texto(p->apellido, p, 0);
+    indexar_texto(p->diagnostico, p, 0);
+    indices.total--;
+    liberar_paciente(h);
+}
+
+// Sólo cambia de grupo si el paciente no estaba ya en el grupo del tope
+void reindexar_turnos(int h, int turnos_antes) {
+    int antes = clave_turnos(turnos_antes);
+    int ahora = clave_turnos(almacen.turnos_espera[h]);
+    if (antes == ahora) return;
+    Paciente* p = ficha_paciente(h);
+    indice_quitar(indices.por_turnos, antes, p);
+    indice_agregar(indices.por_turnos, ahora, p);
+}
+
+void consulta_vacia(ConsultaPacientes* c) {
+    c->texto = NULL;
+    c->gravedad = 0;
+    c->sala_area = -1;
+    c->insumo_id = 0;
+    c->turnos_min = 0;
+    c->turnos_max = -1;
+    c->sala = -1;
+}
+
+static int cumple_consulta(Paciente* p, ConsultaPacientes* c) {
+    int h = p->handle;
+    if (c->gravedad && almacen.gravedad[h] != c->gravedad) return 0;
+    if (c->sala_area >= 0 && p->sala_area != c->sala_area) return 0;
+    if (c->insumo_id && almacen.insumo_req_id[h] != c->insumo_id) return 0;
+    if (almacen.turnos_espera[h] < c->turnos_min) return 0;
+    if (c->turnos_max >= 0 && almacen.turnos_espera[h] > c->turnos_max) return 0;
+    if (c->sala >= 0 && almacen.sala[h] != c->sala) return 0;
+    return 1;
+}
+
+static void filtrar_conjunto(HashMap* conjunto, ConsultaPacientes* c, ArrayList* resultado) {
+    for (MapPair* par = hashmap_first(conjunto); par; par = hashmap_next(conjunto)) {
+        if (cumple_consulta(par->value, c)) arraylist_pushBack(resultado, par->value);
+    }
+}
+
+// Recorre todos los grupos de un índice entre las claves desde..hasta
+static void filtrar_rango(HashMap* indice, int desde, int hasta,
+                          ConsultaPacientes* c, ArrayList* resultado) {
+    for (int clave = desde; clave <= hasta; clave++) {
+        GrupoIndice* g = grupo_indice(indice, clave);
+        if (g) filtrar_conjunto(g->pacientes, c, resultado);
+    }
+}
+
+static int comparar_por_id(const void* a, const void* b) {
+    const Paciente* pa = *(Paciente* const*)a;
+    const Paciente* pb = *(Paciente* const*)b;
+    return (pa->id > pb->id) - (pa->id < pb->id);
+}
+
+// Deja en resultado los pacientes que cumplen la consulta, ordenados por ID,
+// y devuelve cuántos son. Sólo se recorre la fuente de candidatos más chica
+// entre los filtros usados (un grupo de un índice, un rango de turnos o la
+// sala actual); el resto de los filtros se comprueba sobre cada candidato.
+// Si hay texto, los candidatos salen del trie.
+int consultar_pacientes(TablaSalas* salas, ConsultaPacientes* c, ArrayList* resultado) {
+    arraylist_clean(resultado);
+
+    if (c->texto && c->texto[0] != '\0') {
+        trie_search_prefix(indices.por_texto, c->texto, resultado, -1);
+        arraylist_sort(resultado, comparar_por_id);
+        // Un paciente aparece una vez por cada palabra que coincide
+        int n = arraylist_size(resultado);
+        int quedan = 0;
+        Paciente* anterior = NULL;
+        for (int i = 0; i < n; i++) {
+            Paciente* p = arraylist_get(resultado, i);
+            if (p == anterior || !cumple_consulta(p, c)) continue;
+            arraylist_set(resultado, quedan++, p);
+            anterior = p;
+        }
+        arraylist_truncate(resultado, quedan);
+        return quedan;
+    }
+
+    HashMap* fuente = NULL;
+    Sala* sala = NULL;
+    int usar_turnos = 0;
+    int mejor = indices.total + 1;
+
+    HashMap* indice[3] = {indices.por_gravedad, indices.por_area, indices.por_insumo};
+    int clave[3] = {c->gravedad, c->sala_area, c->insumo_id};
+    int activo[3] = {c->gravedad != 0, c->sala_area >= 0, c->insumo_id != 0};
+    for (int k = 0; k < 3; k++) {
+        if (!activo[k]) continue;
+        GrupoIndice* g = grupo_indice(indice[k], clave[k]);
+        int n = g ? hashmap_size(g->pacientes) : 0;
+        if (n == 0) return 0;
+        if (n < mejor) {
+            mejor = n;
+            fuente = g->pacientes;
+        }
+    }
+
+    int turnos_desde = clave_turnos(c->turnos_min);
+    int turnos_hasta = c->turnos_max >= 0 ? clave_turnos(c->turnos_max) : MAX_TURNOS_INDICE;
+    if (c->turnos_min > 0 || c->turnos_max >= 0) {
+        int n = 0;
+        for (int t = turnos_desde; t <= turnos_hasta; t++) n += indice_contar(indices.por_turnos, t);
+        if (n == 0) return 0;
+        if (n < mejor) {
+            mejor = n;
+            usar_turnos = 1;
+        }
+    }
+
+    if (c->sala >= 0) {
+        sala = sala_por_id(salas, c->sala);
+        if (!sala || sala->num_pacientes == 0) return 0;
+        if (sala->num_pacientes >= mejor) sala = NULL;
+    }
+
+    if (sala) {
+        for (int i = 0; i < sala->num_pacientes; i++) {
+            Paciente* p = ficha_paciente(sala->pacientes[i]);
+            if (cumple_consulta(p, c)) arraylist_pushBack(resultado, p);
+        }
+    } else if (usar_turnos) {
+        filtrar_rango(indices.por_turnos, turnos_desde, turnos_hasta, c, resultado);
+    } else if (fuente) {
+        filtrar_conjunto(fuente, c, resultado);
+    } else {
+        // Sin filtros: todos los pacientes, recorriendo el índice por gravedad
+        filtrar_rango(indices.por_gravedad, 1, 3, c, resultado);
+    }
+
+    arraylist_sort(resultado, comparar_por_id);
+    return arraylist_size(resultado);
+}
+
+// ----------------------------------------------------
+// Contadores por sala: se actualizan en cada llegada, traslado, cura y muerte
+// ----------------------------------------------------
+static int paciente_en_peligro(int h) {
+    return almacen.gravedad[h] == 3 && almacen.turnos_espera[h] >= 2;
+}
+
+void registrar_entrada_sala(Sala* sala, int h) {
+    almacen.sala[h] = sala->id;
+    sala->cambiada = 1;
+    sala->por_gravedad[almacen.gravedad[h]]++;
+    pacientes_por_gravedad[almacen.gravedad[h]]++;
+    if (paciente_en_peligro(h)) sala->en_peligro++;
+}
+
+void registrar_salida_sala(Sala* sala, int h) {
+    sala->cambiada = 1;
+    sala->por_gravedad[almacen.gravedad[h]]--;
+    pacientes_por_gravedad[almacen.gravedad[h]]--;
+    if (paciente_en_peligro(h)) sala->en_peligro--;
+}
+
+// Agrega el paciente al final de la sala. Devuelve 0 si no hay memoria (el
+// paciente queda donde estaba)
+int sala_agregar_paciente(Sala* sala, int h) {
+    if (sala->num_pacientes == sala->cap_pacientes) {
+        int nueva = sala->cap_pacientes ? sala->cap_pacientes * 2 : 8;
+        if (!crecer_arreglo((void**)&sala->pacientes, sizeof(int), nueva, MEM_SALA)) return 0;
+        sala->cap_pacientes = nueva;
+    }
+    almacen.pos_sala[h] = sala->num_pacientes;
+    sala->pacientes[sala->num_pacientes++] = h;
+    registrar_entrada_sala(sala, h);
+    return 1;
+}
+
+// Saca al paciente de la posición pos conservando el orden del resto (los
+// que siguen bajan un lugar) y devuelve su handle
+int sala_quitar_paciente(Sala* sala, int pos) {
+    int h = sala->pacientes[pos];
+    memmove(&sala->pacientes[pos], &sala->pacientes[pos + 1],
+            (sala->num_pacientes - pos - 1) * sizeof(int));
+    sala->num_pacientes--;
+    for (int k = pos; k < sala->num_pacientes; k++) almacen.pos_sala[sala->pacientes[k]] = k;
+    registrar_salida_sala(sala, h);
+    return h;
+}
+
+// Suma un turno de espera a todos los pacientes de la sala en una pasada
+// densa sobre los arreglos del almacén, recontando los pacientes en peligro.
+// Sólo quienes no llegaron al tope del índice por turnos cambian de grupo.
+void avanzar_turno_espera(Sala* sala) {
+    int n = sala->num_pacientes;
+    const int* hs = sala->pacientes;
+    const int* gravedad = almacen.gravedad;
+    int* turnos = almacen.turnos_espera;
+
+    int en_peligro = 0;
+    for (int i = 0; i < n; i++) {
+        int t = ++turnos[hs[i]];
+        en_peligro += (gravedad[hs[i]] == 3) & (t >= 2);
+    }
+    sala->en_peligro = en_peligro;
+    if (n > 0) sala->cambiada = 1;
+
+    for (int i = 0; i < n; i++) {
+        if (turnos[hs[i]] <= MAX_TURNOS_INDICE) reindexar_turnos(hs[i], turnos[hs[i]] - 1);
+    }
+}
+
+// ----------------------------------------------------
+// Asignar todos los pacientes iniciales a Sala de Espera
+// ----------------------------------------------------
+void asignar_pacientes_a_espera(List* pacientes, TablaSalas* salas) {
+    Sala* espera = sala_espera(salas);
+    if (!espera) return;
+
+    Paciente* p = list_first(pacientes);
+    while (p != NULL) {
+        Sala* area = buscar_sala_simbolo(salas, p->area);
+        p->sala_area = area ? area->id : -1;
+        if (p->id >= siguiente_id_paciente) siguiente_id_paciente = p->id + 1;
+        if (sala_agregar_paciente(espera, p->handle)) {
+            admitir_paciente(p->handle);
+        } else {
+            printf("Error de memoria: el paciente ID %d no fue admitido.\n", p->id);
+            liberar_paciente(p->handle);
+        }
+        p = list_next(pacientes);
+    }
+}
+
+// ----------------------------------------------------
+// Asignar insumos iniciales a las salas (incluida Bodega)
+// ----------------------------------------------------
+void asignar_insumos_a_salas(List* insumos, TablaSalas* salas) {
+    CargaInsumo* c = list_first(insumos);
+    while (c != NULL) {
+        Insumo* ins = catalogo.insumos[c->catalogo];
+        Sala* sala = buscar_sala_simbolo(salas, c->ubicacion);
+        if (sala == NULL) {
+            printf("Sala '%s' no existe. No se asigno insumo ID %d (%s).\n",
+                   texto_simbolo(c->ubicacion), ins->id, ins->nombre);
+        } else {
+            Existencia* e = agregar_insumo_sala(sala, ins, c->cantidad, c->vence);
+            // Si es Bodega, además creamos (o sumamos a) su StockDiario
+            if (e && sala->tipo == SALA_BODEGA) {
+                StockDiario* sd = stock_bodega(sala, ins);
+                if (sd) sd->cantidad_total = e->cantidad;
+            }
+        }
+        c = list_next(insumos);
+    }
+}
+
+// ----------------------------------------------------
+// Vistas del estado para lectores en otros hilos
+// ----------------------------------------------------
+// Al terminar cada turno (cada acción del menú del día, cada lote de comandos
+// del servidor y cada cierre de día) el hilo de la simulación copia lo que
+// muestran las pantallas de estado a una VistaHospital y la publica con
+// tdas/epoca. Las pantallas y el panel (HOSPITAL_PANEL) sólo leen vistas: ven
+// un estado consistente aunque las salas cambien mientras tanto, sin locks
+// entre quien lee y quien modifica.
+
+// Cada sala de la vista va en su propio bloque (insumos y pacientes detrás
+// de la VistaSala). Sólo se copian las salas marcadas con cambiada; las demás
+// se comparten con la vista anterior, así que un turno que toca una sala no
+// copia todo el censo.
+static VistaSala* construir_vista_sala(Sala* s) {
+    size_t tam = sizeof(VistaSala) + s->num_insumos * sizeof(VistaInsumo) +
+                 s->num_pacientes * sizeof(VistaPaciente);
+    VistaSala* vs = MEM_MALLOC(tam, MEM_VISTA);
+    if (!vs) return NULL;
+
+    memcpy(vs->nombre, s->nombre, sizeof(vs->nombre));
+    vs->capacidad_pacientes = s->capacidad_pacientes;
+    vs->capacidad_insumos = s->capacidad_insumos;
+    vs->num_pacientes = s->num_pacientes;
+    vs->num_insumos = s->num_insumos;
+    memcpy(vs->por_gravedad, s->por_gravedad, sizeof(vs->por_gravedad));
+    vs->insumos = (VistaInsumo*)(vs + 1);
+    vs->pacientes = (VistaPaciente*)(vs->insumos + s->num_insumos);
+    vs->refs = 1;
+
+    for (int k = 0; k < s->num_pacientes; k++) {
+        int h = s->pacientes[k];
+        Paciente* p = ficha_paciente(h);
+        VistaPaciente* vp = &vs->pacientes[k];
+        vp->id = p->id;
+        memcpy(vp->nombre, p->nombre, sizeof(vp->nombre));
+        memcpy(vp->apellido, p->apellido, sizeof(vp->apellido));
+        vp->gravedad = almacen.gravedad[h];
+        vp->turnos_espera = almacen.turnos_espera[h];
+        vp->insumo_req_id = almacen.insumo_req_id[h];
+        vp->cantidad_req = almacen.cantidad_req[h];
+    }
+    for (int k = 0; k < s->num_insumos; k++) {
+        Existencia* e = &s->insumos[k];
+        Insumo* i = ficha_insumo(e);
+        VistaInsumo* vi = &vs->insumos[k];
+        vi->id = i->id;
+        memcpy(vi->nombre, i->nombre, sizeof(vi->nombre));
+        vi->unidad = texto_simbolo(i->unidad);
+        vi->cantidad = e->cantidad;
+        vi->lotes = heap_size(e->lotes);
+        fecha_desde_dia(proximo_vencimiento(e), vi->vence);
+    }
+    return vs;
+}
+
+// refs sólo lo cambia el hilo de la simulación, que arma las vistas y libera
+// las que ya nadie lee, así que no hace falta que sea atómico
+static void soltar_vista_sala(VistaSala* vs) {
+    if (vs && --vs->refs == 0) MEM_FREE(vs);
+}
+
+// anterior es la última vista armada (NULL si no hay): de ella salen las
+// salas sin cambios
+VistaHospital* construir_vista(TablaSalas* salas, const VistaHospital* anterior) {
+    static long version = 0;
+    if (anterior && anterior->num_salas != salas->cantidad) anterior = NULL;
+    VistaHospital* v = MEM_MALLOC(sizeof(VistaHospital) + salas->cantidad * sizeof(VistaSala*), MEM_VISTA);
+    if (!v) return NULL;
+    v->num_salas = salas->cantidad;
+    v->salas = (VistaSala**)(v + 1);
+
+    for (int id = 0; id < salas->cantidad; id++) {
+        Sala* s = &salas->salas[id];
+        if (anterior && !s->cambiada) {
+            v->salas[id] = anterior->salas[id];
+            v->salas[id]->refs++;
+        } else {
+            v->salas[id] = construir_vista_sala(s);
+        }
+        if (!v->salas[id]) {
+            while (--id >= 0) soltar_vista_sala(v->salas[id]);
+            MEM_FREE(v);
+            return NULL;
+        }
+    }
+    // Recién con la vista completa las salas quedan al día
+    for (int id = 0; id < salas->cantidad; id++) salas->salas[id].cambiada = 0;
+
+    Sala* espera = sala_espera(salas);
+    v->version = ++version;
+    v->dia = dia_actual;
+    v->curados = pacientes_curados;
+    v->fallecidos = pacientes_fallecidos;
+    v->reputacion = reputacion;
+    v->graves = pacientes_por_gravedad[3];
+    v->en_peligro = espera ? espera->en_peligro : 0;
+    v->fichas_vivas = almacen.usados - almacen.num_libres;
+    v->fichas_libres = almacen.num_libres + almacen.capacidad - almacen.usados;
+    v->fichas_maximo = almacen.maximo_vivos;
+    v->fichas_bloques = almacen.num_bloques;
+    return v;
+}
+
+static void liberar_vista(void* vista) {
+    VistaHospital* v = vista;
+    for (int id = 0; id < v->num_salas; id++) soltar_vista_sala(v->salas[id]);
+    MEM_FREE(v);
+}
+
+static int vista_atrasada = 0; // hubo un turno después de la vista vigente
+
+static void armar_vista() {
+    TRAZA_INICIO(traza);
+    VistaHospital* v = construir_vista(salas_global, publicacion_actual(vistas));
+    if (v) {
+        publicacion_publicar(vistas, v);
+        vista_atrasada = 0;
+    }
+    TRAZA_FIN(traza, "publicar_vista", "vista");
+}
+
+// Sólo la llama el hilo de la simulación, con el turno ya terminado. Si no
+// hay lectores en otros hilos no arma nada: la vista se arma cuando una
+// pantalla la pide (vista_vigente)
+void publicar_vista() {
+    if (!vistas) vistas = publicacion_crear(liberar_vista);
+    if (!vistas) return;
+    vista_atrasada = 1;
+    if (publicacion_lectores(vistas) > 0) armar_vista();
+}
+
+// La última vista que publicó el hilo de la simulación, al día con el último
+// turno; para él siempre es válida, porque la vigente no se libera
+static const VistaHospital* vista_vigente() {
+    if (!vistas) vistas = publicacion_crear(liberar_vista);
+    if (!vistas) return NULL;
+    if (vista_atrasada || !publicacion_actual(vistas)) armar_vista();
+    return publicacion_actual(vistas);
+}
+
+// ----------------------------------------------------
+// Mostrar estado de las salas
+// ----------------------------------------------------
+// Cada pantalla se arma completa en un Texto (con los enteros formateados a
+// mano) y se escribe con un solo fwrite. Con censos grandes no se lista todo:
+// la vista empieza con una línea por sala y cada sala se recorre por
+// páginas, con un filtro opcional de gravedad mínima.
+
+#define PACIENTES_POR_PAGINA 20
+
+typedef struct {
+    int gravedad_min;      // 0: todos los pacientes
+    int desde;             // primer paciente a listar, de los que pasan el filtro
+    int cantidad;          // -1: hasta el final
+    int insumos;           // 1: listar también los insumos
+} FiltroSala;
+
+static void texto_paciente(Texto* t, const VistaPaciente* p) {
+    texto_cadena(t, "  Paciente #");
+    texto_entero(t, p->id);
+    texto_cadena(t, ": ");
+    texto_cadena(t, p->nombre);
+    texto_caracter(t, ' ');
+    texto_cadena(t, p->apellido);
+    texto_cadena(t, " (Gravedad: ");
+    texto_entero(t, p->gravedad);
+    texto_cadena(t, ") Turnos espera: ");
+    texto_entero(t, p->turnos_espera);
+    texto_cadena(t, " Requiere ID");
+    texto_entero(t, p->insumo_req_id);
+    texto_cadena(t, " x");
+    texto_entero(t, p->cantidad_req);
+    texto_caracter(t, '\n');
+}
+
+static void texto_insumo(Texto* t, const VistaInsumo* i) {
+    texto_cadena(t, "  Insumo: ");
+    texto_cadena(t, i->nombre);
+    texto_cadena(t, " (ID ");
+    texto_entero(t, i->id);
+    texto_cadena(t, ", ");
+    texto_entero(t, i->cantidad);
+    texto_caracter(t, ' ');
+    texto_cadena(t, i->unidad);
+    texto_cadena(t, ") Vence: ");
+    texto_cadena(t, i->vence);
+    texto_cadena(t, " (");
+    texto_entero(t, i->lotes);
+    texto_cadena(t, i->lotes == 1 ? " lote)\n" : " lotes)\n");
+}
+
+// Escribe el encabezado de la sala y los pacientes de la página; devuelve
+// cuántos pacientes pasan el filtro
+static int texto_sala(Texto* t, const VistaSala* s, const FiltroSala* f) {
+    texto_cadena(t, "\nSala: ");
+    texto_cadena(t, s->nombre);
+    texto_cadena(t, "\nCapacidad: ");
+    texto_entero(t, s->capacidad_pacientes);
+    texto_cadena(t, " pacientes, ");
+    texto_entero(t, s->capacidad_insumos);
+    texto_cadena(t, " insumos\nOcupado:   ");
+    texto_entero(t, s->num_pacientes);
+    texto_cadena(t, " pacientes, ");
+    texto_entero(t, s->num_insumos);
+    texto_cadena(t, " insumos\n");
+    if (s->num_pacientes > 0) {
+        texto_cadena(t, "Gravedad:  ");
+        texto_entero(t, s->por_gravedad[3]);
+        texto_cadena(t, " graves, ");
+        texto_entero(t, s->por_gravedad[2]);
+        texto_cadena(t, " moderados, ");
+        texto_entero(t, s->por_gravedad[1]);
+        texto_cadena(t, " leves\n");
     }
 
-    Sala* s = list_first(salas);
-    while (s != NULL) {
-        if (strcmp(s->nombre, "Sala de Espera") != 0 &&
-            strcmp(s->nombre, "Bodega Central") != 0 &&
-            (destino_preferido == NULL || strcmp(s->nombre, destino_preferido->nombre) != 0)) {
-            if (list_size(s->pacientes) < s->capacidad_pacientes) {
-                printf("%d) %s (ocupado: %d/%d)\n", idx,
-                       s->nombre,
-                       list_size(s->pacientes),
-                       s->capacidad_pacientes);
-                idx++;
+    int hasta = f->cantidad < 0 ? INT_MAX : f->desde + f->cantidad;
+    int pasan = 0;
+    for (int k = 0; k < s->num_pacientes; k++) {
+        const VistaPaciente* p = &s->pacientes[k];
+        if (p->gravedad < f->gravedad_min) continue;
+        if (pasan >= f->desde && pasan < hasta) texto_paciente(t, p);
+        pasan++;
+    }
+    if (f->insumos) {
+        for (int k = 0; k < s->num_insumos; k++) texto_insumo(t, &s->insumos[k]);
+    }
+    return pasan;
+}
+
+// Todas las salas con todos sus pacientes e insumos (lo usa el panel)
+void texto_salas(Texto* t, const VistaHospital* v) {
+    FiltroSala todo = {0, 0, -1, 1};
+    for (int id = 0; id < v->num_salas; id++) texto_sala(t, v->salas[id], &todo);
+}
+
+// Una línea por sala; con gravedad_min sólo se cuentan esos pacientes
+void texto_resumen_salas(Texto* t, const VistaHospital* v, int gravedad_min) {
+    texto_cadena(t, "\nSalas (Dia ");
+    texto_entero(t, v->dia);
+    texto_caracter(t, ')');
+    if (gravedad_min > 1) {
+        texto_cadena(t, " - pacientes con gravedad >= ");
+        texto_entero(t, gravedad_min);
+    }
+    texto_caracter(t, '\n');
+    for (int id = 0; id < v->num_salas; id++) {
+        const VistaSala* s = v->salas[id];
+        int pacientes = 0;
+        for (int g = gravedad_min > 1 ? gravedad_min : 1; g <= 3; g++)
+            pacientes += s->por_gravedad[g];
+        texto_entero_ancho(t, id + 1, 2);
+        texto_cadena(t, ") ");
+        texto_cadena_ancho(t, s->nombre, 24);
+        texto_cadena(t, " pacientes ");
+        texto_entero_ancho(t, pacientes, 6);
+        texto_caracter(t, '/');
+        texto_entero(t, s->capacidad_pacientes);
+        texto_cadena(t, " (G3 ");
+        texto_entero(t, s->por_gravedad[3]);
+        texto_cadena(t, ", G2 ");
+        texto_entero(t, s->por_gravedad[2]);
+        texto_cadena(t, ", G1 ");
+        texto_entero(t, s->por_gravedad[1]);
+        texto_cadena(t, ")  insumos ");
+        texto_entero(t, s->num_insumos);
+        texto_caracter(t, '/');
+        texto_entero(t, s->capacidad_insumos);
+        texto_caracter(t, '\n');
+    }
+}
+
+// Vista interactiva de las salas sobre la última vista publicada: resumen,
+// una sala por páginas y filtro por gravedad. Una línea vacía o 0 vuelve.
+void mostrar_salas() {
+    const VistaHospital* v = vista_vigente();
+    static Texto* pantalla = NULL;
+    if (!pantalla) pantalla = texto_crear(4096);
+    if (!v || !pantalla) return;
+
+    int sala = -1, pagina = 0, gravedad_min = 0;
+    for (;;) {
+        limpiar_pantalla();
+        TRAZA_INICIO(traza);
+        int paginas = 1;
+        if (sala < 0) {
+            texto_resumen_salas(pantalla, v, gravedad_min);
+            texto_cadena(pantalla, "\n[N] Ver sala N  [G]ravedad minima (ej: G3, G0 quita el filtro)  [0] Volver: ");
+        } else {
+            FiltroSala filtro = {gravedad_min, pagina * PACIENTES_POR_PAGINA,
+                                 PACIENTES_POR_PAGINA, pagina == 0};
+            int total = texto_sala(pantalla, v->salas[sala], &filtro);
+            paginas = total > 0 ? (total + PACIENTES_POR_PAGINA - 1) / PACIENTES_POR_PAGINA : 1;
+            texto_cadena(pantalla, "\nPacientes");
+            if (gravedad_min > 1) {
+                texto_cadena(pantalla, " con gravedad >= ");
+                texto_entero(pantalla, gravedad_min);
+            }
+            texto_cadena(pantalla, ": ");
+            texto_entero(pantalla, total);
+            texto_cadena(pantalla, " (pag ");
+            texto_entero(pantalla, pagina + 1);
+            texto_caracter(pantalla, '/');
+            texto_entero(pantalla, paginas);
+            texto_cadena(pantalla, ")\n[P]ag sig  [A]nterior  [I]r a pag N (ej: I12)  [G]ravedad minima  [R]esumen  [0] Volver: ");
+        }
+        texto_volcar(pantalla, stdout);
+        TRAZA_FIN(traza, "mostrar_salas", "salida");
+
+        char entrada[16];
+        if (!fgets(entrada, sizeof(entrada), stdin)) break;
+        if (!strchr(entrada, '\n')) {
+            int c;
+            while ((c = getchar()) != '\n' && c != EOF);
+        }
+        char opcion = entrada[0];
+        if (opcion == '\n' || opcion == '0') break;
+        if (opcion == 'G' || opcion == 'g') {
+            int g = atoi(entrada + 1);
+            gravedad_min = g >= 0 && g <= 3 ? g : gravedad_min;
+            pagina = 0;
+        } else if (opcion == 'R' || opcion == 'r') {
+            sala = -1;
+        } else if (sala >= 0 && (opcion == 'P' || opcion == 'p')) {
+            if (pagina + 1 < paginas) pagina++;
+        } else if (sala >= 0 && (opcion == 'A' || opcion == 'a')) {
+            if (pagina > 0) pagina--;
+        } else if (sala >= 0 && (opcion == 'I' || opcion == 'i')) {
+            int destino = atoi(entrada + 1);
+            if (destino >= 1 && destino <= paginas) pagina = destino - 1;
+        } else {
+            int n = atoi(entrada);
+            if (n >= 1 && n <= v->num_salas) {
+                sala = n - 1;
+                pagina = 0;
+            } else {
+                printf("Opcion invalida.\n");
             }
         }
-        s = list_next(salas);
+    }
+}
+
+// ----------------------------------------------------
+// Transferencia manual de varios pacientes (max 5 por turno)
+// ----------------------------------------------------
+void transferir_pacientes_menu(TablaSalas* salas) {
+    Sala* espera = sala_espera(salas);
+    if (!espera || espera->num_pacientes == 0) {
+        printf("No hay pacientes en Sala de Espera.\n");
+        return;
+    }
+
+    int acciones_restantes = 5;
+    int pagina = 1;
+    int total = espera->num_pacientes;
+    int por_pagina = 10;
+    int max_paginas = (total + por_pagina - 1) / por_pagina;
+    int opcion;
+    while (acciones_restantes > 0 && total > 0) {
+        printf("\nPacientes en Sala de Espera (pag %d/%d). Acciones restantes: %d\n",
+               pagina, max_paginas, acciones_restantes);
+
+        // Mostrar la página actual (acceso directo por posición)
+        int inicio = (pagina - 1) * por_pagina;
+        for (int i = 0; i < por_pagina && inicio + i < total; i++) {
+            int h = espera->pacientes[inicio + i];
+            Paciente* p = ficha_paciente(h);
+            printf("%2d) ID %d - %s %s - Gravedad %d - Turnos %d\n",
+                   i + 1, p->id, p->nombre, p->apellido, almacen.gravedad[h], almacen.turnos_espera[h]);
+        }
+
+        printf("\n[1-%d] Transferir paciente  [P]ag sig  [A]nterior  [I]r a pag N (ej: I12)  [0] Salir: ", por_pagina);
+        char input[16];
+        if (!fgets(input, sizeof(input), stdin)) break;
+
+        if (input[0] == 'P' || input[0] == 'p') {
+            if (pagina < max_paginas) pagina++;
+            else printf("Ya estas en la ultima pagina.\n");
+            continue;
+        }
+        if (input[0] == 'A' || input[0] == 'a') {
+            if (pagina > 1) pagina--;
+            else printf("Ya estas en la primera pagina.\n");
+            continue;
+        }
+        if (input[0] == 'I' || input[0] == 'i') {
+            int destino = atoi(input + 1);
+            if (destino >= 1 && destino <= max_paginas) pagina = destino;
+            else printf("Pagina invalida (1-%d).\n", max_paginas);
+            continue;
+        }
+
+        opcion = atoi(input);
+        if (opcion == 0) break;
+        if (opcion < 1 || opcion > por_pagina || inicio + opcion > total) {
+            printf("Opcion invalida.\n");
+            continue;
+        }
+
+        // Transferir paciente individual
+        if (!transferir_paciente_unico(salas, inicio + (opcion - 1))) continue;
+        acciones_restantes--;
+        total--;
+        max_paginas = (total + por_pagina - 1) / por_pagina;
+        if (pagina > max_paginas) pagina = max_paginas;
+    }
+
+    if (acciones_restantes == 0) {
+        printf("Has agotado tus acciones de transferencia para este turno.\n");
+    }
+}
+
+// ----------------------------------------------------
+// Transferir un solo paciente (subfunción de arriba)
+// ----------------------------------------------------
+// pos es la posición del paciente en Sala de Espera. Devuelve 1 si se
+// transfirió y 0 si se canceló.
+int transferir_paciente_unico(TablaSalas* salas, int pos) {
+    Sala* espera = sala_espera(salas);
+    if (!espera || pos < 0 || pos >= espera->num_pacientes) return 0;
+    int h = espera->pacientes[pos];
+    Paciente* p = ficha_paciente(h);
+
+    printf("\nTransferir Paciente ID %d (%s %s, Gravedad %d):\n",
+           p->id, p->nombre, p->apellido, almacen.gravedad[h]);
+
+    int idx = 1;
+    Sala* destino_preferido = sala_por_id(salas, p->sala_area);
+    if (destino_preferido && destino_preferido->tipo == SALA_CLINICA &&
+        destino_preferido->num_pacientes < destino_preferido->capacidad_pacientes) {
+        printf("%d) %s (ocupado: %d/%d)\n", idx,
+               destino_preferido->nombre,
+               destino_preferido->num_pacientes,
+               destino_preferido->capacidad_pacientes);
+        idx++;
+    } else {
+        destino_preferido = NULL;
+    }
+
+    for (int k = 0; k < salas->num_clinicas; k++) {
+        Sala* s = &salas->salas[salas->clinicas[k]];
+        if (s != destino_preferido &&
+            s->num_pacientes < s->capacidad_pacientes) {
+            printf("%d) %s (ocupado: %d/%d)\n", idx,
+                   s->nombre,
+                   s->num_pacientes,
+                   s->capacidad_pacientes);
+            idx++;
+        }
     }
     printf("0) Cancelar\n");
 
-    int opcion_sala;
-    scanf("%d", &opcion_sala);
-    getchar();
+    int opcion_sala = leer_opcion(0);
     if (opcion_sala == 0) {
         printf("Transferencia cancelada.\n");
-        return;
+        return 0;
     }
 
     Sala* sala_destino = NULL;
@@ -456,215 +2044,180 @@ void transferir_paciente_unico(List* salas, Paciente* p) {
     }
 
     if (!sala_destino) {
-        s = list_first(salas);
-        while (s != NULL) {
-            if (strcmp(s->nombre, "Sala de Espera") != 0 &&
-                strcmp(s->nombre, "Bodega Central") != 0 &&
-                (destino_preferido == NULL || strcmp(s->nombre, destino_preferido->nombre) != 0)) {
-                if (list_size(s->pacientes) < s->capacidad_pacientes) {
-                    if (opcion_sala == contador) {
-                        sala_destino = s;
-                        break;
-                    }
-                    contador++;
+        for (int k = 0; k < salas->num_clinicas; k++) {
+            Sala* s = &salas->salas[salas->clinicas[k]];
+            if (s != destino_preferido &&
+                s->num_pacientes < s->capacidad_pacientes) {
+                if (opcion_sala == contador) {
+                    sala_destino = s;
+                    break;
                 }
+                contador++;
             }
-            s = list_next(salas);
         }
     }
 
     if (!sala_destino) {
         printf("Opcion invalida.\n");
-        return;
+        return 0;
     }
 
     // Verificar espacio en destino
-    if (list_size(sala_destino->pacientes) >= sala_destino->capacidad_pacientes) {
-        printf("Sala %s esta llena. No se puede transferir.\n", sala_destino->nombre);
-        return;
+    int movido = mover_desde_espera(salas, pos, sala_destino);
+    if (movido < 0) {
+        printf("Error de memoria.\n");
+        return 0;
     }
-
-    list_pushBack(sala_destino->pacientes, p);
-
-    // Eliminar de Sala de Espera
-    Paciente* buscado = list_first(espera->pacientes);
-    while (buscado != NULL) {
-        if (buscado == p) {
-            list_popCurrent(espera->pacientes);
-            break;
-        }
-        buscado = list_next(espera->pacientes);
+    if (!movido) {
+        printf("Sala %s esta llena. No se puede transferir.\n", sala_destino->nombre);
+        return 0;
     }
 
     printf("Paciente ID %d transferido a %s.\n", p->id, sala_destino->nombre);
+    return 1;
 }
 
-void limpiarPantalla() { system("clear"); }
-void presioneTeclaParaContinuar() {
-  puts("Presione una tecla para continuar...");
-  getchar(); // Consume el '\n' del buffer de entrada
-  getchar(); // Espera a que el usuario presione una tecla
-}
-// ----------------------------------------------------
-// Ejecutar un turno: muertes y auto-transferencias
-// ----------------------------------------------------
-void ejecutar_turno(List* salas) {
-    Sala* espera = buscar_sala(salas, "Sala de Espera");
-    Sala* urgencias = buscar_sala(salas, "Urgencias");
-    Sala* uci = buscar_sala(salas, "UCI");
-
-    if (!espera) return;
-
-    int n = list_size(espera->pacientes);
-    for (int idx = 0; idx < n; idx++) {
-        Paciente* p = list_first(espera->pacientes);
-        if (!p) break;
-
-        p->turnos_espera++;
-
-        // Auto-transferir gravedad 3
-        if (p->gravedad == 3) {
-            if (urgencias && list_size(urgencias->pacientes) < urgencias->capacidad_pacientes) {
-                list_pushBack(urgencias->pacientes, p);
-                list_popCurrent(espera->pacientes);
-                printf("Paciente #%d transferido a Urgencias (gravedad 3).\n", p->id);
-                continue;
-            } else if (uci && list_size(uci->pacientes) < uci->capacidad_pacientes) {
-                list_pushBack(uci->pacientes, p);
-                list_popCurrent(espera->pacientes);
-                printf("Paciente #%d transferido a UCI (gravedad 3).\n", p->id);
-                continue;
-            }
-        }
-
-        // Muertes por exceso de espera
-        if ((p->gravedad == 3 && p->turnos_espera > 2) ||
-            (p->gravedad == 2 && p->turnos_espera > 3)) {
-            pacientes_fallecidos++;
-            reputacion -= 2;
-            printf("Paciente #%d murio en Sala de Espera (gravedad %d, turnos %d).\n",
-                   p->id, p->gravedad, p->turnos_espera);
-            list_popCurrent(espera->pacientes);
-        } else {
-            list_pushBack(espera->pacientes, p);
-            list_popCurrent(espera->pacientes);
-        }
-    }
-
-    printf("Turno finalizado.\n");
+// Pasa al paciente de la posición pos de la Sala de Espera a destino si tiene
+// cupo. Devuelve 1 si lo movió, 0 si no hay cupo y -1 si no hay memoria (el
+// paciente sigue en espera).
+int mover_desde_espera(TablaSalas* salas, int pos, Sala* destino) {
+    Sala* espera = sala_espera(salas);
+    if (!espera || pos < 0 || pos >= espera->num_pacientes) return 0;
+    if (destino->num_pacientes >= destino->capacidad_pacientes) return 0;
+
+    uint64_t inicio = metricas_ahora_ns();
+    int h = espera->pacientes[pos];
+    if (!sala_agregar_paciente(destino, h)) return -1;
+    sala_quitar_paciente(espera, pos);
+    contador_sumar(metricas.transferencias, 1);
+    histograma_desde(metricas.transferir, inicio);
+    return 1;
 }
 
 // ----------------------------------------------------
 // Generar pacientes nuevos cada día (aleatorio 3–8)
 // ----------------------------------------------------
+static const char* NOMBRES_ALEATORIOS[] = {
+    "Ana", "Jose", "Camila", "Matias", "Laura", "Ricardo", "Mariana", "Diego",
+    "Sofia", "Carlos", "Elena", "Andres", "Valentina", "Pedro", "Isabel"
+};
+static const char* APELLIDOS_ALEATORIOS[] = {
+    "Perez", "Gonzalez", "Salazar", "Rojas", "Vega", "Suarez", "Munoz", "Torres",
+    "Ramirez", "Fernandez", "Quintero", "Gomez", "Diaz", "Lopez"
+};
+
 void generar_pacientes_nuevos() {
     int n = rand() % 6 + 3;  // entre 3 y 8
     printf("Llegan %d pacientes nuevos al hospital.\n", n);
 
-    Sala* espera = buscar_sala(salas_global, "Sala de Espera");
-    if (!espera) return;
-
-    const char* areas[] = {
-        "UCI", "Urgencias", "Ginecologia",
-        "Traumatologia", "Medicina Interna", "Pediatria"
-    };
+    Sala* espera = sala_espera(salas_global);
+    if (!espera || salas_global->num_clinicas == 0) return;
+    reservar_pacientes(n);
 
     for (int i = 0; i < n; i++) {
-        Paciente* p = malloc(sizeof(Paciente));
-        if (!p) continue;
+        int h = crear_paciente();
+        if (h < 0) continue;
+        Paciente* p = ficha_paciente(h);
 
         p->id = siguiente_id_paciente++;
         int prob = rand() % 100;
-        if (prob < 20) p->gravedad = 3;
-        else if (prob < 50) p->gravedad = 2;
-        else p->gravedad = 1;
-
-        strcpy(p->area, areas[rand() % 6]);
+        int gravedad;
+        if (prob < 20) gravedad = 3;
+        else if (prob < 50) gravedad = 2;
+        else gravedad = 1;
+        almacen.gravedad[h] = gravedad;
+
+        snprintf(p->nombre, sizeof(p->nombre), "%s",
+                 NOMBRES_ALEATORIOS[rand() % (sizeof(NOMBRES_ALEATORIOS) / sizeof(NOMBRES_ALEATORIOS[0]))]);
+        snprintf(p->apellido, sizeof(p->apellido), "%s",
+                 APELLIDOS_ALEATORIOS[rand() % (sizeof(APELLIDOS_ALEATORIOS) / sizeof(APELLIDOS_ALEATORIOS[0]))]);
+
+        // El área es una de las salas clínicas configuradas
+        Sala* area = &salas_global->salas[salas_global->clinicas[rand() % salas_global->num_clinicas]];
+        p->sala_area = area->id;
+        p->area = area->simbolo;
         strcpy(p->diagnostico, "Condicion aleatoria");
         p->edad = rand() % 90 + 1;
-        p->turnos_espera = 0;
-
-        if (p->gravedad == 3) {
-            p->insumo_req_id = 1005;
-            p->cantidad_req = 3;
-        } else if (p->gravedad == 2) {
-            p->insumo_req_id = 1001;
-            p->cantidad_req = 2;
-        } else {
-            p->insumo_req_id = 1003;
-            p->cantidad_req = 1;
-        }
 
-        list_pushBack(espera->pacientes, p);
+        almacen.insumo_req_id[h] = tratamientos[gravedad].insumo_id;
+        almacen.cantidad_req[h] = tratamientos[gravedad].cantidad;
+
+        if (!sala_agregar_paciente(espera, h)) {
+            printf("Error de memoria: el paciente ID %d no fue admitido.\n", p->id);
+            liberar_paciente(h);
+            return;
+        }
+        admitir_paciente(h);
     }
 }
 
+// ----------------------------------------------------
+// Leer la opción numérica de un menú
+// ----------------------------------------------------
+// Consume la línea completa. Si la entrada no es un número devuelve -1 (opción
+// inválida) y si se terminó devuelve al_terminar, que debe ser la opción de
+// salir o cancelar de ese menú; así un guion de entrada que se acaba no deja
+// al programa en un ciclo infinito.
+int leer_opcion(int al_terminar) {
+    int opcion;
+    int leidos = scanf("%d", &opcion);
+    if (leidos == EOF) return al_terminar;
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF);
+    if (leidos != 1) return c == EOF ? al_terminar : -1;
+    return opcion;
+}
+
 // ----------------------------------------------------
 // Mostrar estadísticas y alertas antes de cada acción
 // ----------------------------------------------------
-void mostrar_encabezado() {
-    int en_peligro = 0;
-    Sala* espera = buscar_sala(salas_global, "Sala de Espera");
-    if (espera) {
-        Paciente* p = list_first(espera->pacientes);
-        while (p != NULL) {
-            if (p->gravedad == 3 && p->turnos_espera >= 2) {
-                en_peligro++;
-            }
-            p = list_next(espera->pacientes);
-        }
-    }
+void escribir_encabezado(FILE* f, const VistaHospital* v) {
+    fprintf(f, "\n======= ESTADISTICAS (Dia %d) =======\n", v->dia);
+    fprintf(f, "Curados:   %d    Fallecidos: %d    Reputacion: %d    Pacientes Graves: %d\n",
+            v->curados, v->fallecidos, v->reputacion, v->graves);
 
-    int pacientes_graves = 0;
-    Sala* s = list_first(salas_global);
-    while (s != NULL) {
-        Paciente* p = list_first(s->pacientes);
-        while (p != NULL) {
-            if (p->gravedad == 3) pacientes_graves++;
-            p = list_next(s->pacientes);
-        }
-        s = list_next(salas_global);
+    if (v->en_peligro > 0) {
+        fprintf(f, "ALERTA! %d paciente(s) de gravedad 3 en peligro (1 turno)\n", v->en_peligro);
     }
+    fprintf(f, "=====================================\n");
+}
 
-    printf("\n======= ESTADISTICAS (Dia %d) =======\n", dia_actual);
-    printf("Curados:   %d    Fallecidos: %d    Reputacion: %d    Pacientes Graves: %d\n",
-           pacientes_curados, pacientes_fallecidos, reputacion, pacientes_graves);
-
-    if (en_peligro > 0) {
-        printf("ALERTA! %d paciente(s) de gravedad 3 en peligro (1 turno)\n", en_peligro);
-    }
-    printf("=====================================\n");
+void mostrar_encabezado() {
+    const VistaHospital* v = vista_vigente();
+    if (v) escribir_encabezado(stdout, v);
 }
 
 // ----------------------------------------------------
 // Atender (curar) un paciente en una sala
 // ----------------------------------------------------
-void atender_paciente(List* salas) {
+void atender_paciente(TablaSalas* salas) {
     int contador_sal = 0;
-    Sala* s = list_first(salas);
 
     printf("\nSalas con pacientes y al menos 1 insumo disponible:\n");
-    while (s != NULL) {
-        if (list_size(s->pacientes) > 0 && list_size(s->insumos) > 0) {
+    for (int id = 0; id < salas->cantidad; id++) {
+        Sala* s = &salas->salas[id];
+        if (s->num_pacientes > 0 && s->num_insumos > 0) {
             contador_sal++;
             printf("%d) %s (Pacientes: %d, Insumos: %d)\n",
                    contador_sal,
                    s->nombre,
-                   list_size(s->pacientes),
-                   list_size(s->insumos));
+                   s->num_pacientes,
+                   s->num_insumos);
         }
-        s = list_next(salas);
     }
 
     if (contador_sal == 0) {
         printf("No hay ninguna sala con pacientes e insumos suficientes.\n");
         return;
     }
+    printf("%d) Todas las salas: curar a todos los pacientes posibles\n", contador_sal + 1);
 
     printf("Seleccione el numero de sala para atender un paciente (0 para cancelar): ");
-    int opcion_sala;
-    scanf("%d", &opcion_sala);
-    getchar();
+    int opcion_sala = leer_opcion(0);
+    if (opcion_sala == contador_sal + 1) {
+        curar_pacientes_lote(salas, NULL);
+        return;
+    }
     if (opcion_sala <= 0 || opcion_sala > contador_sal) {
         printf("Operacion cancelada o sala invalida.\n");
         return;
@@ -672,16 +2225,15 @@ void atender_paciente(List* salas) {
 
     int indice_actual = 0;
     Sala* sala_elegida = NULL;
-    s = list_first(salas);
-    while (s != NULL) {
-        if (list_size(s->pacientes) > 0 && list_size(s->insumos) > 0) {
+    for (int id = 0; id < salas->cantidad; id++) {
+        Sala* s = &salas->salas[id];
+        if (s->num_pacientes > 0 && s->num_insumos > 0) {
             indice_actual++;
             if (indice_actual == opcion_sala) {
                 sala_elegida = s;
                 break;
             }
         }
-        s = list_next(salas);
     }
     if (!sala_elegida) {
         printf("Error al encontrar sala seleccionada.\n");
@@ -689,89 +2241,345 @@ void atender_paciente(List* salas) {
     }
 
     printf("\nPacientes en %s:\n", sala_elegida->nombre);
-    int contador_pac = 0;
-    Paciente* p = list_first(sala_elegida->pacientes);
-    while (p != NULL) {
-        contador_pac++;
+    int contador_pac = sala_elegida->num_pacientes;
+    for (int k = 0; k < contador_pac; k++) {
+        int h = sala_elegida->pacientes[k];
+        Paciente* p = ficha_paciente(h);
         printf("%d) ID %d - %s %s - Gravedad %d - Turnos espera %d - Requiere insumo %d x%d\n",
-               contador_pac,
-               p->id, p->nombre, p->apellido, p->gravedad, p->turnos_espera,
-               p->insumo_req_id, p->cantidad_req);
-        p = list_next(sala_elegida->pacientes);
+               k + 1,
+               p->id, p->nombre, p->apellido, almacen.gravedad[h], almacen.turnos_espera[h],
+               almacen.insumo_req_id[h], almacen.cantidad_req[h]);
     }
+    printf("%d) Curar a todos los pacientes posibles de esta sala\n", contador_pac + 1);
 
     printf("Seleccione el numero de paciente para curar (0 para cancelar): ");
-    int opcion_pac;
-    scanf("%d", &opcion_pac);
-    getchar();
+    int opcion_pac = leer_opcion(0);
+    if (opcion_pac == contador_pac + 1) {
+        curar_pacientes_lote(salas, sala_elegida);
+        return;
+    }
     if (opcion_pac <= 0 || opcion_pac > contador_pac) {
         printf("Operacion cancelada o paciente invalido.\n");
         return;
     }
 
-    int indice2 = 0;
-    p = list_first(sala_elegida->pacientes);
-    while (p != NULL) {
-        indice2++;
-        if (indice2 == opcion_pac) break;
-        p = list_next(sala_elegida->pacientes);
-    }
-    if (!p) {
-        printf("Error al encontrar paciente.\n");
-        return;
-    }
+    curar_paciente(sala_elegida, opcion_pac - 1);
+}
 
-    Insumo* ins_req = NULL;
-    Insumo* cand = list_first(sala_elegida->insumos);
-    while (cand != NULL) {
-        if (cand->id == p->insumo_req_id) {
-            ins_req = cand;
-            break;
-        }
-        cand = list_next(sala_elegida->insumos);
-    }
+// Cura al paciente de la posición pos de la sala con el insumo que requiere.
+// Devuelve CURA_OK o el motivo por el que no se pudo.
+int curar_paciente(Sala* sala, int pos) {
+    uint64_t inicio = metricas_ahora_ns();
+    int h = sala->pacientes[pos];
+    Paciente* p = ficha_paciente(h);
+    int cantidad_req = almacen.cantidad_req[h];
+
+    Existencia* ins_req = buscar_insumo(sala, almacen.insumo_req_id[h]);
     if (!ins_req) {
-        printf("No hay el insumo requerido (ID %d) en esta sala. No se puede atender.\n", p->insumo_req_id);
-        return;
+        printf("No hay el insumo requerido (ID %d) en esta sala. No se puede atender.\n", almacen.insumo_req_id[h]);
+        return CURA_SIN_INSUMO;
     }
 
-    if (ins_req->cantidad < p->cantidad_req) {
+    Insumo* datos_req = ficha_insumo(ins_req);
+    if (ins_req->cantidad < cantidad_req) {
         printf("Insuficiente stock de '%s' (requiere %d, disponible %d). No se puede atender.\n",
-               ins_req->nombre, p->cantidad_req, ins_req->cantidad);
-        return;
+               datos_req->nombre, cantidad_req, ins_req->cantidad);
+        return CURA_STOCK_INSUFICIENTE;
     }
 
-    ins_req->cantidad -= p->cantidad_req;
+    registrar_consumo(ins_req, cantidad_req);
     printf("\nSe han consumido %d unidades de '%s' para atender al paciente.\n",
-           p->cantidad_req, ins_req->nombre);
+           cantidad_req, datos_req->nombre);
 
     if (ins_req->cantidad == 0) {
-        list_popCurrent(sala_elegida->insumos);
-        printf("El insumo '%s' se agoto y fue eliminado de la sala.\n", ins_req->nombre);
+        quitar_insumo_sala(sala, ins_req);
+        printf("El insumo '%s' se agoto y fue eliminado de la sala.\n", datos_req->nombre);
     }
 
     printf("Paciente ID %d (%s %s) ha sido curado y sale de la sala.\n",
            p->id, p->nombre, p->apellido);
-    list_popCurrent(sala_elegida->pacientes);
+    sala_quitar_paciente(sala, pos);
+    dar_alta_paciente(h);
     pacientes_curados++;
     reputacion++;
+    contador_sumar(metricas.curados, 1);
+    histograma_desde(metricas.atender, inicio);
+    return CURA_OK;
+}
+
+// ----------------------------------------------------
+// Curar en lote todos los pacientes posibles de una sala
+// ----------------------------------------------------
+// Los pacientes se atienden por prioridad (gravedad 3, 2, 1 y, a igual
+// gravedad, por orden de llegada) y el stock se reserva a través del índice
+// por ID de la sala. Devuelve la cantidad de pacientes curados; los contadores
+// globales los actualiza quien llama, una vez por lote.
+int curar_lote_sala(Sala* sala) {
+    int n = sala->num_pacientes;
+    if (n == 0 || sala->num_insumos == 0) return 0;
+    int* hs = sala->pacientes;
+    const int* gravedad = almacen.gravedad;
+
+    int* orden = MEM_MALLOC(n * sizeof(int), MEM_TEMPORAL);
+    char* curado = MEM_CALLOC(n, sizeof(char), MEM_TEMPORAL);
+    if (!orden || !curado) {
+        MEM_FREE(orden); MEM_FREE(curado);
+        return 0;
+    }
+
+    // Ordenamiento por conteo según gravedad (estable): 3, luego 2 y 1
+    int cuenta[4] = {0};
+    int i;
+    for (i = 0; i < n; i++) cuenta[gravedad[hs[i]]]++;
+    int inicio[4];
+    inicio[3] = 0;
+    inicio[2] = cuenta[3];
+    inicio[1] = cuenta[3] + cuenta[2];
+    for (i = 0; i < n; i++) orden[inicio[gravedad[hs[i]]]++] = i;
+
+    int curados = 0;
+    int agotados = 0;
+    for (int k = 0; k < n; k++) {
+        int h = hs[orden[k]];
+        Existencia* ins = buscar_insumo(sala, almacen.insumo_req_id[h]);
+        if (!ins || ins->cantidad < almacen.cantidad_req[h]) continue;
+        registrar_consumo(ins, almacen.cantidad_req[h]);
+        if (ins->cantidad == 0) agotados = 1;
+        curado[orden[k]] = 1;
+        curados++;
+    }
+
+    // Una sola pasada para sacar a los curados conservando el orden; los
+    // contadores de la sala se ajustan una vez al final
+    if (curados > 0) {
+        int salidas[4] = {0};
+        int salidas_en_peligro = 0;
+        int quedan = 0;
+        for (i = 0; i < n; i++) {
+            int h = hs[i];
+            if (!curado[i]) {
+                almacen.pos_sala[h] = quedan;
+                hs[quedan++] = h;
+                continue;
+            }
+            salidas[gravedad[h]]++;
+            if (paciente_en_peligro(h)) salidas_en_peligro++;
+            dar_alta_paciente(h);
+        }
+        sala->num_pacientes = quedan;
+        sala->cambiada = 1;
+        for (int g = 1; g <= 3; g++) {
+            sala->por_gravedad[g] -= salidas[g];
+            pacientes_por_gravedad[g] -= salidas[g];
+        }
+        sala->en_peligro -= salidas_en_peligro;
+    }
+
+    // Y otra para retirar los insumos agotados
+    if (agotados) {
+        for (i = sala->num_insumos - 1; i >= 0; i--) {
+            if (sala->insumos[i].cantidad == 0) quitar_insumo_sala(sala, &sala->insumos[i]);
+        }
+    }
+
+    MEM_FREE(orden);
+    MEM_FREE(curado);
+    return curados;
+}
+
+// ----------------------------------------------------
+// Curar en lote una sala o, si sala es NULL, todo el hospital
+// ----------------------------------------------------
+void curar_pacientes_lote(TablaSalas* salas, Sala* sala) {
+    uint64_t inicio = metricas_ahora_ns();
+    TRAZA_INICIO(traza);
+    int total = 0;
+    if (sala) {
+        total = curar_lote_sala(sala);
+        printf("%s: %d paciente(s) curado(s), %d siguen en la sala.\n",
+               sala->nombre, total, sala->num_pacientes);
+    } else {
+        for (int k = 0; k < salas->num_clinicas; k++) {
+            Sala* s = &salas->salas[salas->clinicas[k]];
+            int curados = curar_lote_sala(s);
+            if (curados > 0) {
+                printf("%s: %d paciente(s) curado(s), %d siguen en la sala.\n",
+                       s->nombre, curados, s->num_pacientes);
+            }
+            total += curados;
+        }
+    }
+
+    pacientes_curados += total;
+    reputacion += total;
+    contador_sumar(metricas.curados, total);
+    histograma_desde(metricas.curar_lote, inicio);
+    TRAZA_FIN(traza, "curar_pacientes_lote", "turno");
+    printf("Total: %d paciente(s) curado(s) en este lote.\n", total);
 }
 
 // ----------------------------------------------------
 // Mostrar estadísticas globales
 // ----------------------------------------------------
+void escribir_estadisticas(FILE* f, const VistaHospital* v) {
+    fprintf(f, "\n=== ESTADISTICAS ===\n");
+    fprintf(f, "Pacientes curados:    %d\n", v->curados);
+    fprintf(f, "Pacientes fallecidos: %d\n", v->fallecidos);
+    fprintf(f, "Reputacion:           %d\n", v->reputacion);
+    fprintf(f, "Fichas de pacientes:  %d vivas, %d libres, maximo %d (%d bloques)\n",
+            v->fichas_vivas, v->fichas_libres, v->fichas_maximo, v->fichas_bloques);
+}
+
 void mostrar_estadisticas() {
-    printf("\n=== ESTADISTICAS ===\n");
-    printf("Pacientes curados:    %d\n", pacientes_curados);
-    printf("Pacientes fallecidos: %d\n", pacientes_fallecidos);
-    printf("Reputacion:           %d\n", reputacion);
+    const VistaHospital* v = vista_vigente();
+    if (v) escribir_estadisticas(stdout, v);
+}
+
+// ----------------------------------------------------
+// Resumen del estado para comparar corridas (HOSPITAL_RESUMEN)
+// ----------------------------------------------------
+
+// Escribe una línea del resumen y la acumula en el hash FNV-1a
+static void linea_resumen(FILE* f, uint64_t* hash, const char* formato, ...) {
+    char linea[256];
+    va_list args;
+    va_start(args, formato);
+    vsnprintf(linea, sizeof(linea), formato, args);
+    va_end(args);
+    for (const unsigned char* c = (const unsigned char*)linea; *c; c++) {
+        *hash ^= *c;
+        *hash *= 1099511628211ull;
+    }
+    fprintf(f, "%s\n", linea);
+}
+
+static int comparar_int(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int comparar_handle_por_id(const void* a, const void* b) {
+    int x = ficha_paciente(*(const int*)a)->id, y = ficha_paciente(*(const int*)b)->id;
+    return (x > y) - (x < y);
+}
+
+// Las salas salen en el orden de salas.csv; los pacientes y los insumos de
+// cada sala se ordenan por ID para que el resumen no dependa del orden
+// interno de los arreglos.
+void escribir_resumen_estado(FILE* f) {
+    uint64_t hash = 14695981039346656037ull;
+    linea_resumen(f, &hash, "dia %d", dia_actual);
+    linea_resumen(f, &hash, "curados %d", pacientes_curados);
+    linea_resumen(f, &hash, "fallecidos %d", pacientes_fallecidos);
+    linea_resumen(f, &hash, "reputacion %d", reputacion);
+    linea_resumen(f, &hash, "pacientes %d (gravedad 1: %d, 2: %d, 3: %d)",
+                  almacen.usados - almacen.num_libres, pacientes_por_gravedad[1],
+                  pacientes_por_gravedad[2], pacientes_por_gravedad[3]);
+
+    for (int id = 0; id < salas_global->cantidad; id++) {
+        Sala* s = &salas_global->salas[id];
+        int n = s->num_pacientes > s->num_insumos ? s->num_pacientes : s->num_insumos;
+        int* ids = MEM_MALLOC((n > 0 ? n : 1) * sizeof(int), MEM_TEMPORAL);
+        if (!ids) return;
+
+        linea_resumen(f, &hash, "sala %s: %d pacientes, %d insumos",
+                      s->nombre, s->num_pacientes, s->num_insumos);
+        memcpy(ids, s->pacientes, s->num_pacientes * sizeof(int));
+        qsort(ids, s->num_pacientes, sizeof(int), comparar_handle_por_id);
+        for (int k = 0; k < s->num_pacientes; k++) {
+            int h = ids[k];
+            linea_resumen(f, &hash, "  paciente %d gravedad %d turnos %d",
+                          ficha_paciente(h)->id, almacen.gravedad[h], almacen.turnos_espera[h]);
+        }
+
+        for (int k = 0; k < s->num_insumos; k++)
+            ids[k] = ficha_insumo(&s->insumos[k])->id;
+        qsort(ids, s->num_insumos, sizeof(int), comparar_int);
+        for (int k = 0; k < s->num_insumos; k++) {
+            Existencia* e = buscar_insumo(s, ids[k]);
+            char vence[20];
+            fecha_desde_dia(proximo_vencimiento(e), vence);
+            linea_resumen(f, &hash, "  insumo %d cantidad %d lotes %d vence %s",
+                          ids[k], e->cantidad, heap_size(e->lotes), vence);
+        }
+        MEM_FREE(ids);
+    }
+    fprintf(f, "hash %016llx\n", (unsigned long long)hash);
+}
+
+// ----------------------------------------------------
+// Buscar pacientes combinando filtros (usa los índices secundarios)
+// ----------------------------------------------------
+#define MAX_RESULTADOS_BUSQUEDA 50
+
+// Lee el nombre de una sala; devuelve su ID, -1 si se deja vacío o -2 si no existe
+static int leer_sala_filtro(TablaSalas* salas, const char* mensaje) {
+    char nombre[50];
+    printf("%s", mensaje);
+    if (!fgets(nombre, sizeof(nombre), stdin)) return -1;
+    nombre[strcspn(nombre, "\n")] = '\0';
+    if (nombre[0] == '\0') return -1;
+    Sala* s = buscar_sala(salas, nombre);
+    if (!s) {
+        printf("No existe la sala '%s'.\n", nombre);
+        return -2;
+    }
+    return s->id;
+}
+
+void buscar_pacientes_menu(TablaSalas* salas) {
+    static ArrayList* resultado = NULL;
+    if (!resultado) resultado = arraylist_create();
+    if (!resultado) return;
+
+    ConsultaPacientes c;
+    consulta_vacia(&c);
+    char texto[50];
+
+    printf("\n=== BUSCAR PACIENTES ===\n");
+    printf("Deje en 0 o vacio los filtros que no quiera usar.\n");
+    printf("Nombre, apellido o diagnostico (inicio de una palabra): ");
+    if (fgets(texto, sizeof(texto), stdin)) {
+        texto[strcspn(texto, "\n")] = '\0';
+        c.texto = texto;
+    }
+    printf("Gravedad (1-3): ");
+    scanf("%d", &c.gravedad);
+    getchar();
+    if ((c.sala_area = leer_sala_filtro(salas, "Area (nombre de la sala): ")) == -2) return;
+    printf("ID del insumo requerido: ");
+    scanf("%d", &c.insumo_id);
+    getchar();
+    printf("Turnos de espera minimos: ");
+    scanf("%d", &c.turnos_min);
+    getchar();
+    printf("Turnos de espera maximos (-1 sin maximo): ");
+    scanf("%d", &c.turnos_max);
+    getchar();
+    if ((c.sala = leer_sala_filtro(salas, "Sala donde se encuentra: ")) == -2) return;
+
+    TRAZA_INICIO(inicio);
+    int n = consultar_pacientes(salas, &c, resultado);
+    TRAZA_FIN(inicio, "consultar_pacientes", "consulta");
+    printf("\n%d paciente(s) encontrado(s).\n", n);
+    for (int i = 0; i < n && i < MAX_RESULTADOS_BUSQUEDA; i++) {
+        Paciente* p = arraylist_get(resultado, i);
+        int h = p->handle;
+        Sala* sala = sala_por_id(salas, almacen.sala[h]);
+        printf("  ID %d | %s %s | Area: %s | Gravedad %d | Turnos %d | Insumo %d (x%d) | %s\n",
+               p->id, p->nombre, p->apellido, texto_simbolo(p->area), almacen.gravedad[h], almacen.turnos_espera[h],
+               almacen.insumo_req_id[h], almacen.cantidad_req[h], sala ? sala->nombre : "-");
+    }
+    if (n > MAX_RESULTADOS_BUSQUEDA) {
+        printf("  ... y %d mas.\n", n - MAX_RESULTADOS_BUSQUEDA);
+    }
 }
 
 // ----------------------------------------------------
 // Función para pedir insumos a proveedor (sin límite diario)
 // ----------------------------------------------------
-void pedir_insumos_proveedor(List* salas) {
-    Sala* bodega = buscar_sala(salas, "Bodega Central");
+void pedir_insumos_proveedor(TablaSalas* salas) {
+    Sala* bodega = sala_bodega(salas);
     if (!bodega) {
         printf("No se encontro la Bodega Central.\n");
         return;
@@ -781,18 +2589,11 @@ void pedir_insumos_proveedor(List* salas) {
     int idx = 1;
     StockDiario* sd = list_first(bodega->stock_diario);
     while (sd != NULL) {
-        Insumo* ins = NULL;
-        Insumo* cand = list_first(bodega->insumos);
-        while (cand != NULL) {
-            if (cand->id == sd->id_insumo) {
-                ins = cand;
-                break;
-            }
-            cand = list_next(bodega->insumos);
-        }
+        Insumo* ins = insumo_por_id(sd->id_insumo);
         if (ins) {
-            printf("%d) ID %d – %s – Stock actual: %d unidades\n",
-                   idx, ins->id, ins->nombre, sd->cantidad_total);
+            DemandaInsumo* d = &catalogo.demanda[ins->indice];
+            printf("%d) ID %d – %s – Stock actual: %d unidades (demanda %.1f/dia, punto de pedido %d)\n",
+                   idx, ins->id, ins->nombre, sd->cantidad_total, d->promedio, d->punto_pedido);
         }
         sd = list_next(bodega->stock_diario);
         idx++;
@@ -802,9 +2603,7 @@ void pedir_insumos_proveedor(List* salas) {
     }
 
     printf("\nSeleccione el numero de insumo a reabastecer (0 para crear uno nuevo): ");
-    int opcion_ins;
-    scanf("%d", &opcion_ins);
-    getchar();
+    int opcion_ins = leer_opcion(0);
 
     if (opcion_ins > 0 && opcion_ins < idx) {
         sd = list_first(bodega->stock_diario);
@@ -815,16 +2614,9 @@ void pedir_insumos_proveedor(List* salas) {
             printf("Error interno al seleccionar insumo.\n");
             return;
         }
-        Insumo* ins_sel = NULL;
-        Insumo* cand2 = list_first(bodega->insumos);
-        while (cand2 != NULL) {
-            if (cand2->id == sd->id_insumo) {
-                ins_sel = cand2;
-                break;
-            }
-            cand2 = list_next(bodega->insumos);
-        }
-        if (!ins_sel) {
+        Insumo* ins_sel = insumo_por_id(sd->id_insumo);
+        Existencia* e_sel = buscar_insumo(bodega, sd->id_insumo);
+        if (!ins_sel || !e_sel) {
             printf("Error: insumo no encontrado en lista.\n");
             return;
         }
@@ -836,47 +2628,67 @@ void pedir_insumos_proveedor(List* salas) {
             printf("Cantidad invalida. Operacion cancelada.\n");
             return;
         }
-        sd->cantidad_total += cant_add;
-        ins_sel->cantidad = sd->cantidad_total;
+        agregar_lote(e_sel, vence_reposicion(ins_sel), cant_add);
+        sd->cantidad_total = e_sel->cantidad;
         printf("Se agregaron %d unidades a '%s'. Nuevo stock en Bodega: %d\n",
                cant_add, ins_sel->nombre, sd->cantidad_total);
     }
     else if (opcion_ins == 0) {
-        Insumo* nuevoIns = malloc(sizeof(Insumo));
-        if (!nuevoIns) {
-            printf("Error de memoria.\n");
-            return;
-        }
+        Insumo datos;
+        int cantidad;
+        int vence;
         printf("Ingrese ID numerico para el nuevo insumo: ");
-        scanf("%d", &nuevoIns->id);
+        scanf("%d", &datos.id);
         getchar();
-        printf("Ingrese nombre del insumo: ");
-        fgets(nuevoIns->nombre, sizeof(nuevoIns->nombre), stdin);
-        nuevoIns->nombre[strcspn(nuevoIns->nombre, "\n")] = '\0';
-        printf("Ingrese tipo de insumo (e.g. Medicamento, Instrumental): ");
-        fgets(nuevoIns->tipo, sizeof(nuevoIns->tipo), stdin);
-        nuevoIns->tipo[strcspn(nuevoIns->tipo, "\n")] = '\0';
+        if (buscar_stock(bodega, datos.id)) {
+            printf("Ya existe un insumo con ID %d en Bodega. Operacion cancelada.\n", datos.id);
+            return;
+        }
+
+        // Si el insumo ya está en el catálogo (en otra sala) sólo falta la cantidad
+        Insumo* nuevoIns = insumo_por_id(datos.id);
+        if (nuevoIns) {
+            printf("El insumo ID %d ('%s') ya esta en el catalogo.\n", nuevoIns->id, nuevoIns->nombre);
+            vence = vence_reposicion(nuevoIns);
+        } else {
+            char texto[50] = "";
+            printf("Ingrese nombre del insumo: ");
+            fgets(datos.nombre, sizeof(datos.nombre), stdin);
+            datos.nombre[strcspn(datos.nombre, "\n")] = '\0';
+            printf("Ingrese tipo de insumo (e.g. Medicamento, Instrumental): ");
+            fgets(texto, sizeof(texto), stdin);
+            texto[strcspn(texto, "\n")] = '\0';
+            datos.tipo = simbolo(texto);
+            printf("Ingrese unidad (e.g. unidades, cajas): ");
+            fgets(texto, sizeof(texto), stdin);
+            texto[strcspn(texto, "\n")] = '\0';
+            datos.unidad = simbolo(texto);
+            printf("Ingrese fecha de vencimiento (YYYY-MM-DD) o '-' si no aplica: ");
+            fgets(texto, sizeof(texto), stdin);
+            texto[strcspn(texto, "\n")] = '\0';
+            vence = dia_desde_fecha(texto);
+            datos.vida_util = vida_util_desde(vence);
+            nuevoIns = registrar_insumo(&datos);
+            if (!nuevoIns) {
+                printf("Error de memoria.\n");
+                return;
+            }
+        }
         printf("Ingrese unidades a stockear: ");
-        scanf("%d", &nuevoIns->cantidad);
+        scanf("%d", &cantidad);
         getchar();
-        printf("Ingrese unidad (e.g. unidades, cajas): ");
-        fgets(nuevoIns->unidad, sizeof(nuevoIns->unidad), stdin);
-        nuevoIns->unidad[strcspn(nuevoIns->unidad, "\n")] = '\0';
-        printf("Ingrese fecha de vencimiento (YYYY-MM-DD) o '-' si no aplica: ");
-        fgets(nuevoIns->fecha_vencimiento, sizeof(nuevoIns->fecha_vencimiento), stdin);
-        nuevoIns->fecha_vencimiento[strcspn(nuevoIns->fecha_vencimiento, "\n")] = '\0';
-        strcpy(nuevoIns->ubicacion, "Bodega Central");
-
-        StockDiario* sd_n = malloc(sizeof(StockDiario));
-        sd_n->id_insumo = nuevoIns->id;
-        sd_n->cantidad_total = nuevoIns->cantidad;
-        sd_n->retirado_hoy = 0;
-        list_pushBack(bodega->stock_diario, sd_n);
-
-        list_pushBack(bodega->insumos, nuevoIns);
+        if (cantidad < 0) cantidad = 0;
+
+        StockDiario* sd_n = stock_bodega(bodega, nuevoIns);
+        if (!sd_n) {
+            printf("Error de memoria.\n");
+            return;
+        }
+        Existencia* e_n = agregar_insumo_sala(bodega, nuevoIns, cantidad, vence);
+        sd_n->cantidad_total = e_n->cantidad;
 
         printf("Nuevo insumo '%s' (ID %d) agregado con %d unidades en Bodega Central.\n",
-               nuevoIns->nombre, nuevoIns->id, nuevoIns->cantidad);
+               nuevoIns->nombre, nuevoIns->id, cantidad);
     }
     else {
         printf("Opcion invalida. Operacion cancelada.\n");
@@ -886,31 +2698,23 @@ void pedir_insumos_proveedor(List* salas) {
 // ----------------------------------------------------
 // Distribuir insumos de Bodega a salas (respetando cuota diaria)
 // ----------------------------------------------------
-void distribuir_insumos_a_salass(List* salas, int* limite_diario) {
-    Sala* bodega = buscar_sala(salas, "Bodega Central");
+void distribuir_insumos_a_salass(TablaSalas* salas, int* limite_diario) {
+    Sala* bodega = sala_bodega(salas);
     if (!bodega) {
         printf("No se encontro la Bodega Central.\n");
         return;
     }
 
+    // La lista mostrada y la elección numeran igual: sólo los insumos con
+    // stock, en el orden de Bodega
     printf("\nInsumos en Bodega Central (Stock, RetiradoHoy), Cuota restante hoy = %d\n", *limite_diario);
     int idx = 1;
     StockDiario* sd = list_first(bodega->stock_diario);
     while (sd != NULL) {
-        if (sd->cantidad_total > 0) {
-            Insumo* ins = NULL;
-            Insumo* cand = list_first(bodega->insumos);
-            while (cand != NULL) {
-                if (cand->id == sd->id_insumo) {
-                    ins = cand;
-                    break;
-                }
-                cand = list_next(bodega->insumos);
-            }
-            if (ins) {
-                printf("%d) %s (ID %d) – Stock=%d, RetiradoHoy=%d\n",
-                       idx, ins->nombre, ins->id, sd->cantidad_total, sd->retirado_hoy);
-            }
+        Insumo* ins = insumo_por_id(sd->id_insumo);
+        if (sd->cantidad_total > 0 && ins) {
+            printf("%d) %s (ID %d) – Stock=%d, RetiradoHoy=%d\n",
+                   idx, ins->nombre, ins->id, sd->cantidad_total, sd->retirado_hoy);
             idx++;
         }
         sd = list_next(bodega->stock_diario);
@@ -921,147 +2725,318 @@ void distribuir_insumos_a_salass(List* salas, int* limite_diario) {
     }
 
     printf("Seleccione numero de insumo para distribuir (0 para cancelar): ");
-    int opcion_ins;
-    scanf("%d", &opcion_ins);
-    getchar();
+    int opcion_ins = leer_opcion(0);
     if (opcion_ins <= 0 || opcion_ins >= idx) {
         printf("Solicitud cancelada.\n");
         return;
     }
 
-    sd = list_first(bodega->stock_diario);
-    for (int i = 1; i < opcion_ins; i++) {
-        sd = list_next(bodega->stock_diario);
+    idx = 0;
+    sd = list_first(bodega->stock_diario);
+    while (sd != NULL) {
+        if (sd->cantidad_total > 0 && insumo_por_id(sd->id_insumo) && ++idx == opcion_ins) break;
+        sd = list_next(bodega->stock_diario);
+    }
+    if (!sd) {
+        printf("Error al seleccionar insumo o stock 0.\n");
+        return;
+    }
+
+    printf("Ingrese cantidad a retirar (maximo %d, stock Bodega=%d): ",
+           *limite_diario, sd->cantidad_total);
+    int cantidad_retirar = leer_opcion(0);
+    const char* error = validar_retiro(sd, cantidad_retirar, *limite_diario);
+    if (error) {
+        printf("%s\n", error);
+        return;
+    }
+
+    printf("\nSeleccione sala destino para este insumo:\n");
+    int contador_sal = salas->num_clinicas;
+    for (int k = 0; k < salas->num_clinicas; k++) {
+        Sala* s = &salas->salas[salas->clinicas[k]];
+        printf("%d) %s (insumos: %d, cap: %d)\n",
+               k + 1, s->nombre, s->num_insumos, s->capacidad_insumos);
+    }
+    if (contador_sal == 0) {
+        printf("No hay salas destino disponibles.\n");
+        return;
+    }
+
+    printf("Seleccione numero de sala destino (0 para cancelar): ");
+    int opcion_sal_dest = leer_opcion(0);
+    if (opcion_sal_dest <= 0 || opcion_sal_dest > contador_sal) {
+        printf("Operacion cancelada o sala invalida.\n");
+        return;
+    }
+
+    Sala* sala_destino = sala_por_id(salas, salas->clinicas[opcion_sal_dest - 1]);
+    if (!sala_destino) {
+        printf("Error al encontrar sala destino.\n");
+        return;
+    }
+
+    uint64_t inicio = metricas_ahora_ns();
+    Insumo* ins_dest = retirar_de_bodega(bodega, sd, sala_destino,
+                                         cantidad_retirar, limite_diario);
+    histograma_desde(metricas.distribuir, inicio);
+
+    printf("Se han retirado %d unidades de '%s' para %s.\n",
+           cantidad_retirar,
+           ((ins_dest) ? ins_dest->nombre : "<insumo desconocido>"),
+           sala_destino->nombre);
+}
+
+// Devuelve NULL si se pueden retirar cantidad unidades de ese stock con la
+// cuota que queda, o el motivo por el que no
+const char* validar_retiro(StockDiario* sd, int cantidad, int limite_diario) {
+    static char motivo[100];
+    if (cantidad <= 0) return "Cantidad invalida.";
+    if (cantidad > limite_diario) {
+        snprintf(motivo, sizeof(motivo), "No puede retirar tanto hoy (excede cuota diaria = %d).", limite_diario);
+        return motivo;
     }
-    if (!sd || sd->cantidad_total <= 0) {
-        printf("Error al seleccionar insumo o stock 0.\n");
-        return;
+    if (cantidad > sd->cantidad_total) {
+        snprintf(motivo, sizeof(motivo), "No hay suficiente stock en bodega (solo quedan %d).", sd->cantidad_total);
+        return motivo;
     }
+    return NULL;
+}
 
-    printf("Ingrese cantidad a retirar (maximo %d, stock Bodega=%d): ",
-           *limite_diario, sd->cantidad_total);
-    int cantidad_retirar;
-    scanf("%d", &cantidad_retirar);
-    getchar();
-    if (cantidad_retirar <= 0) {
-        printf("Cantidad invalida.\n");
-        return;
+// ----------------------------------------------------
+// Mover unidades de Bodega a una sala (descuenta stock y cuota)
+// ----------------------------------------------------
+// Los lotes salen de Bodega por orden de vencimiento (FEFO) y llegan a la
+// sala con la misma fecha.
+Insumo* retirar_de_bodega(Sala* bodega, StockDiario* sd, Sala* destino,
+                          int cantidad, int* limite_diario) {
+    TRAZA_INICIO(traza);
+    sd->retirado_hoy   += cantidad;
+    *limite_diario     -= cantidad;
+    contador_sumar(metricas.unidades_retiradas, cantidad);
+
+    Insumo* ins = insumo_por_id(sd->id_insumo);
+    Existencia* orig = buscar_insumo(bodega, sd->id_insumo);
+    Existencia* dest = ins ? existencia_sala(destino, ins) : NULL;
+    if (orig) {
+        consumir_lotes(orig, cantidad, dest);
+        sd->cantidad_total = orig->cantidad;
+    } else {
+        sd->cantidad_total -= cantidad;
     }
-    if (cantidad_retirar > *limite_diario) {
-        printf("No puede retirar tanto hoy (excede cuota diaria = %d).\n", *limite_diario);
+    TRAZA_FIN(traza, "retirar_de_bodega", "bodega");
+    return ins;
+}
+
+// ----------------------------------------------------
+// Distribución optimizada: plan de retiro que maximiza pacientes curables
+// ----------------------------------------------------
+
+// Demanda de un paciente de sala clínica
+typedef struct {
+    int id_insumo;
+    int orden_sala;
+    int cantidad;
+    Sala* sala;
+} DemandaPaciente;
+
+// Pacientes de una misma sala que requieren el mismo insumo
+typedef struct {
+    Sala* sala;
+    StockDiario* sd;
+    int sku;               // posición en el arreglo de stock restante
+    int cantidad_plan;     // unidades a retirar para esta sala
+    int pacientes_plan;    // pacientes que pasan a ser curables
+} GrupoDemanda;
+
+// Paciente que aún no puede curarse con el stock de su sala
+typedef struct {
+    int costo;             // unidades que faltan en la sala para curarlo
+    int grupo;
+    int orden;             // posición dentro del grupo
+} CandidatoRetiro;
+
+static int comparar_demanda(const void* a, const void* b) {
+    const DemandaPaciente* x = a;
+    const DemandaPaciente* y = b;
+    if (x->id_insumo != y->id_insumo) return x->id_insumo < y->id_insumo ? -1 : 1;
+    if (x->orden_sala != y->orden_sala) return x->orden_sala < y->orden_sala ? -1 : 1;
+    return x->cantidad - y->cantidad;
+}
+
+static int comparar_candidatos(const void* a, const void* b) {
+    const CandidatoRetiro* x = a;
+    const CandidatoRetiro* y = b;
+    if (x->costo != y->costo) return x->costo < y->costo ? -1 : 1;
+    if (x->grupo != y->grupo) return x->grupo < y->grupo ? -1 : 1;
+    return x->orden - y->orden;
+}
+
+// Dentro de cada grupo los pacientes se cubren de menor a mayor cantidad, así
+// el costo de cada uno no decrece. Tomar los candidatos de menor costo mientras
+// alcance la cuota y el stock del insumo maximiza el número de pacientes
+// curables (cualquier solución puede cambiar su candidato más caro por el más
+// barato disponible sin dejar de ser válida).
+void distribuir_insumos_optimizado(TablaSalas* salas, int* limite_diario) {
+    Sala* bodega = sala_bodega(salas);
+    if (!bodega) {
+        printf("No se encontro la Bodega Central.\n");
         return;
     }
-    if (cantidad_retirar > sd->cantidad_total) {
-        printf("No hay suficiente stock en bodega (solo quedan %d).\n", sd->cantidad_total);
+    if (*limite_diario <= 0) {
+        printf("La cuota diaria de retiro esta agotada.\n");
         return;
     }
 
-    printf("\nSeleccione sala destino para este insumo:\n");
-    int contador_sal = 0;
-    Sala* s = list_first(salas);
-    while (s != NULL) {
-        if (strcmp(s->nombre, "Sala de Espera") != 0 &&
-            strcmp(s->nombre, "Bodega Central") != 0) {
-            contador_sal++;
-            printf("%d) %s (insumos: %d, cap: %d)\n",
-                   contador_sal, s->nombre, list_size(s->insumos), s->capacidad_insumos);
-        }
-        s = list_next(salas);
+    // 1. Demanda pendiente de los pacientes en salas clínicas
+    int total = 0;
+    for (int k = 0; k < salas->num_clinicas; k++) {
+        total += salas->salas[salas->clinicas[k]].num_pacientes;
     }
-    if (contador_sal == 0) {
-        printf("No hay salas destino disponibles.\n");
+    if (total == 0) {
+        printf("No hay pacientes en salas clinicas.\n");
         return;
     }
 
-    printf("Seleccione numero de sala destino (0 para cancelar): ");
-    int opcion_sal_dest;
-    scanf("%d", &opcion_sal_dest);
-    getchar();
-    if (opcion_sal_dest <= 0 || opcion_sal_dest > contador_sal) {
-        printf("Operacion cancelada o sala invalida.\n");
+    DemandaPaciente* demanda = MEM_MALLOC(total * sizeof(DemandaPaciente), MEM_TEMPORAL);
+    GrupoDemanda* grupos = MEM_MALLOC(total * sizeof(GrupoDemanda), MEM_TEMPORAL);
+    CandidatoRetiro* candidatos = MEM_MALLOC(total * sizeof(CandidatoRetiro), MEM_TEMPORAL);
+    int* restante_sku = MEM_MALLOC(total * sizeof(int), MEM_TEMPORAL);
+    if (!demanda || !grupos || !candidatos || !restante_sku) {
+        printf("Error de memoria.\n");
+        MEM_FREE(demanda); MEM_FREE(grupos); MEM_FREE(candidatos); MEM_FREE(restante_sku);
         return;
     }
 
-    int idx_sal = 0;
-    Sala* sala_destino = NULL;
-    s = list_first(salas);
-    while (s != NULL) {
-        if (strcmp(s->nombre, "Sala de Espera") != 0 &&
-            strcmp(s->nombre, "Bodega Central") != 0) {
-            idx_sal++;
-            if (idx_sal == opcion_sal_dest) {
-                sala_destino = s;
-                break;
+    int n = 0;
+    for (int k = 0; k < salas->num_clinicas; k++) {
+        Sala* s = &salas->salas[salas->clinicas[k]];
+        for (int j = 0; j < s->num_pacientes; j++) {
+            int h = s->pacientes[j];
+            if (almacen.cantidad_req[h] > 0) {
+                demanda[n].id_insumo = almacen.insumo_req_id[h];
+                demanda[n].orden_sala = s->id;
+                demanda[n].cantidad = almacen.cantidad_req[h];
+                demanda[n].sala = s;
+                n++;
             }
         }
-        s = list_next(salas);
     }
-    if (!sala_destino) {
-        printf("Error al encontrar sala destino.\n");
-        return;
+    qsort(demanda, n, sizeof(DemandaPaciente), comparar_demanda);
+
+    // 2. Costo de cada paciente no cubierto por el stock actual de su sala
+    int ngrupos = 0, ncandidatos = 0, nsku = 0;
+    StockDiario* sd_actual = NULL;
+    int i = 0;
+    while (i < n) {
+        int fin = i;
+        while (fin < n && demanda[fin].id_insumo == demanda[i].id_insumo &&
+               demanda[fin].orden_sala == demanda[i].orden_sala) fin++;
+
+        StockDiario* sd = buscar_stock(bodega, demanda[i].id_insumo);
+        if (sd && sd->cantidad_total > 0) {
+            if (sd != sd_actual) {
+                restante_sku[nsku++] = sd->cantidad_total;
+                sd_actual = sd;
+            }
+            Existencia* ins = buscar_insumo(demanda[i].sala, demanda[i].id_insumo);
+            int disponible = ins ? ins->cantidad : 0;
+            int k = i;
+            while (k < fin && demanda[k].cantidad <= disponible) {
+                disponible -= demanda[k].cantidad;
+                k++;
+            }
+            if (k < fin) {
+                GrupoDemanda* g = &grupos[ngrupos];
+                g->sala = demanda[i].sala;
+                g->sd = sd;
+                g->sku = nsku - 1;
+                g->cantidad_plan = 0;
+                g->pacientes_plan = 0;
+                for (int orden = 0; k < fin; k++, orden++) {
+                    candidatos[ncandidatos].costo = demanda[k].cantidad - disponible;
+                    candidatos[ncandidatos].grupo = ngrupos;
+                    candidatos[ncandidatos].orden = orden;
+                    ncandidatos++;
+                    disponible = 0; // el sobrante sólo sirve al primero
+                }
+                ngrupos++;
+            }
+        }
+        i = fin;
     }
 
-    sd->cantidad_total  -= cantidad_retirar;
-    sd->retirado_hoy    += cantidad_retirar;
-    *limite_diario      -= cantidad_retirar;
+    // 3. Selección voraz por costo
+    qsort(candidatos, ncandidatos, sizeof(CandidatoRetiro), comparar_candidatos);
+    int cuota = *limite_diario;
+    for (int c = 0; c < ncandidatos && candidatos[c].costo <= cuota; c++) {
+        GrupoDemanda* g = &grupos[candidatos[c].grupo];
+        if (candidatos[c].costo > restante_sku[g->sku]) continue;
+        cuota -= candidatos[c].costo;
+        restante_sku[g->sku] -= candidatos[c].costo;
+        g->cantidad_plan += candidatos[c].costo;
+        g->pacientes_plan++;
+    }
 
-    Insumo* ins_dest = NULL;
-    Insumo* cand2 = list_first(sala_destino->insumos);
-    while (cand2 != NULL) {
-        if (cand2->id == sd->id_insumo) {
-            ins_dest = cand2;
-            break;
-        }
-        cand2 = list_next(sala_destino->insumos);
+    // 4. Aplicar el plan completo de una vez
+    int unidades = 0, curables = 0;
+    printf("\nPlan de distribucion (cuota disponible hoy = %d):\n", *limite_diario);
+    for (int g = 0; g < ngrupos; g++) {
+        if (grupos[g].cantidad_plan == 0) continue;
+        Insumo* ins = retirar_de_bodega(bodega, grupos[g].sd, grupos[g].sala,
+                                        grupos[g].cantidad_plan, limite_diario);
+        printf("  %s <- %d x '%s' (ID %d): %d paciente(s) curable(s)\n",
+               grupos[g].sala->nombre, grupos[g].cantidad_plan,
+               ins ? ins->nombre : "<insumo desconocido>",
+               grupos[g].sd->id_insumo, grupos[g].pacientes_plan);
+        unidades += grupos[g].cantidad_plan;
+        curables += grupos[g].pacientes_plan;
     }
-    if (ins_dest) {
-        ins_dest->cantidad += cantidad_retirar;
+    if (unidades == 0) {
+        printf("  No hay retiros que permitan curar pacientes adicionales hoy.\n");
     } else {
-        Insumo* nuevoIns = malloc(sizeof(Insumo));
-        Insumo* orig = list_first(bodega->insumos);
-        while (orig != NULL) {
-            if (orig->id == sd->id_insumo) {
-                nuevoIns->id = orig->id;
-                strcpy(nuevoIns->nombre, orig->nombre);
-                strcpy(nuevoIns->tipo, orig->tipo);
-                nuevoIns->cantidad = cantidad_retirar;
-                strcpy(nuevoIns->unidad, orig->unidad);
-                strcpy(nuevoIns->fecha_vencimiento, orig->fecha_vencimiento);
-                strcpy(nuevoIns->ubicacion, sala_destino->nombre);
-                break;
-            }
-            orig = list_next(bodega->insumos);
-        }
-        list_pushBack(sala_destino->insumos, nuevoIns);
+        printf("Se retiraron %d unidades; %d paciente(s) adicionales pueden ser curados. Cuota restante: %d\n",
+               unidades, curables, *limite_diario);
     }
 
-    printf("Se han retirado %d unidades de '%s' para %s.\n",
-           cantidad_retirar,
-           ((cand2) ? cand2->nombre : "<insumo desconocido>"),
-           sala_destino->nombre);
+    MEM_FREE(demanda);
+    MEM_FREE(grupos);
+    MEM_FREE(candidatos);
+    MEM_FREE(restante_sku);
 }
 
 // ----------------------------------------------------
-// Submenú para gestionar Bodega (Pedir o Distribuir)
+// Submenú para gestionar Bodega (Pedir, Distribuir u Optimizar)
 // ----------------------------------------------------
-void gestionar_bodega(List* salas, int* limite_diario) {
+void gestionar_bodega(TablaSalas* salas, int* limite_diario) {
     int opcion_bodega;
     do {
         printf("\n--- Gestionar Bodega Central ---\n");
         printf("  a) 1. Pedir insumos a proveedor\n");
         printf("  b) 2. Distribuir insumos de Bodega a salas (cuota diaria: %d)\n", *limite_diario);
-        printf("  c) 0. Volver al menu anterior\n");
+        printf("  c) 3. Distribucion optimizada segun demanda de pacientes\n");
+        printf("  d) 0. Volver al menu anterior\n");
         printf("Seleccione una opcion: ");
-        scanf("%d", &opcion_bodega);
-        getchar();
+        opcion_bodega = leer_opcion(0);
 
         switch (opcion_bodega) {
             case 1:
                 pedir_insumos_proveedor(salas);
                 break;
-            case 2:
+            case 2: {
+                TRAZA_INICIO(traza);
                 distribuir_insumos_a_salass(salas, limite_diario);
+                TRAZA_FIN(traza, "distribuir_insumos", "bodega");
+                break;
+            }
+            case 3: {
+                uint64_t inicio = metricas_ahora_ns();
+                TRAZA_INICIO(traza);
+                distribuir_insumos_optimizado(salas, limite_diario);
+                histograma_desde(metricas.distribuir_optimizado, inicio);
+                TRAZA_FIN(traza, "distribuir_insumos_optimizado", "bodega");
                 break;
+            }
             case 0:
                 printf("Volviendo al menu de Acciones.\n");
                 break;
@@ -1075,46 +3050,58 @@ void gestionar_bodega(List* salas, int* limite_diario) {
 // Procesos de fin de día: muertes, reinicio cuota, reposición
 // ----------------------------------------------------
 void ejecutar_procesos_fin_dia() {
-    Sala* espera = buscar_sala(salas_global, "Sala de Espera");
+    uint64_t inicio = metricas_ahora_ns();
+    TRAZA_INICIO(traza);
+    Sala* espera = sala_espera(salas_global);
     if (espera) {
-        int n = list_size(espera->pacientes);
+        TRAZA_INICIO(barrido);
+        int critica = 0;        // ver sala_critica_con_cupo
+        avanzar_turno_espera(espera);
+
+        int n = espera->num_pacientes;
+        int quedan = 0;
         for (int idx = 0; idx < n; idx++) {
-            Paciente* p = list_first(espera->pacientes);
-            if (!p) break;
+            int h = espera->pacientes[idx];
+            int gravedad = almacen.gravedad[h];
+            int turnos = almacen.turnos_espera[h];
 
-            p->turnos_espera++;
-            if ((p->gravedad == 3 && p->turnos_espera > 2) ||
-                (p->gravedad == 2 && p->turnos_espera > 3)) {
+            if ((gravedad == 3 && turnos > 2) ||
+                (gravedad == 2 && turnos > 3)) {
                 pacientes_fallecidos++;
+                contador_sumar(metricas.fallecidos, 1);
                 reputacion -= 2;
                 printf("Paciente #%d murio en Sala de Espera (gravedad %d, turnos %d).\n",
-                       p->id, p->gravedad, p->turnos_espera);
-                list_popCurrent(espera->pacientes);
+                       ficha_paciente(h)->id, gravedad, turnos);
+                registrar_salida_sala(espera, h);
+                dar_alta_paciente(h);
                 continue;
             }
 
-            if (p->gravedad == 3) {
-                Sala* urgencias = buscar_sala(salas_global, "Urgencias");
-                Sala* uci = buscar_sala(salas_global, "UCI");
-                if (urgencias && list_size(urgencias->pacientes) < urgencias->capacidad_pacientes) {
-                    list_pushBack(urgencias->pacientes, p);
-                    list_popCurrent(espera->pacientes);
-                    printf("Paciente #%d (gravedad 3) transferido automaticamente a Urgencias.\n", p->id);
-                    continue;
-                } else if (uci && list_size(uci->pacientes) < uci->capacidad_pacientes) {
-                    list_pushBack(uci->pacientes, p);
-                    list_popCurrent(espera->pacientes);
-                    printf("Paciente #%d (gravedad 3) transferido automaticamente a UCI.\n", p->id);
-                    continue;
-                }
+            // Sin memoria para moverlo, sigue en espera
+            Sala* destino = gravedad == 3 ? sala_critica_con_cupo(salas_global, &critica) : NULL;
+            if (destino && sala_agregar_paciente(destino, h)) {
+                registrar_salida_sala(espera, h);
+                contador_sumar(metricas.transferencias, 1);
+                printf("Paciente #%d (gravedad 3) transferido automaticamente a %s.\n",
+                       ficha_paciente(h)->id, destino->nombre);
+                continue;
             }
 
-            list_pushBack(espera->pacientes, p);
-            list_popCurrent(espera->pacientes);
+            almacen.pos_sala[h] = quedan;
+            espera->pacientes[quedan++] = h;
         }
+        espera->num_pacientes = quedan;
+        TRAZA_FIN(barrido, "barrido_sala_espera", "fin_dia");
+    }
+
+    TRAZA_INICIO(vencidos);
+    int vencidas = retirar_insumos_vencidos(salas_global);
+    TRAZA_FIN(vencidos, "retirar_insumos_vencidos", "fin_dia");
+    if (vencidas > 0) {
+        printf("Fin del dia: se retiraron %d unidades vencidas.\n", vencidas);
     }
 
-    Sala* bodega = buscar_sala(salas_global, "Bodega Central");
+    Sala* bodega = sala_bodega(salas_global);
     if (bodega) {
         StockDiario* sd = list_first(bodega->stock_diario);
         while (sd != NULL) {
@@ -1124,49 +3111,150 @@ void ejecutar_procesos_fin_dia() {
         printf("Fin del dia: cuota diaria de retiro de insumos restablecida.\n");
     }
 
-    if (bodega) {
-        StockDiario* sd2 = list_first(bodega->stock_diario);
-        while (sd2 != NULL) {
-            int tope_max = 200;
-            int reposicion = 10;
-            if (sd2->cantidad_total + reposicion > tope_max) {
-                reposicion = tope_max - sd2->cantidad_total;
-            }
-            if (reposicion > 0) {
-                sd2->cantidad_total += reposicion;
-                Insumo* ins_ori = list_first(bodega->insumos);
-                while (ins_ori != NULL) {
-                    if (ins_ori->id == sd2->id_insumo) {
-                        ins_ori->cantidad = sd2->cantidad_total;
-                        break;
-                    }
-                    ins_ori = list_next(bodega->insumos);
-                }
-            }
-            sd2 = list_next(bodega->stock_diario);
-        }
-        printf("Reabastecimiento parcial: cada insumo en bodega +10 unidades (hasta tope).\n");
+    TRAZA_INICIO(pedidos);
+    int pedidas = generar_pedidos_automaticos(salas_global);
+    TRAZA_FIN(pedidos, "generar_pedidos_automaticos", "fin_dia");
+    if (pedidas > 0) {
+        printf("Pedidos automaticos: llegaron %d unidades a Bodega.\n", pedidas);
     }
 
     printf("\n--- Resumen Dia %d ---\n", dia_actual);
     printf("Curados hoy: %d  |  Fallecidos hoy: %d  |  Reputacion actual: %d\n\n",
            pacientes_curados, pacientes_fallecidos, reputacion);
+
+    histograma_desde(metricas.fin_dia, inicio);
+    TRAZA_FIN(traza, "ejecutar_procesos_fin_dia", "dia");
+
+    // Sólo escribe algo si se compiló con -DMEMORIA_INSTRUMENTADA
+    char titulo[40];
+    snprintf(titulo, sizeof(titulo), "fin del dia %d", dia_actual);
+    mem_report(stdout, titulo);
+}
+
+// ----------------------------------------------------
+// Pronóstico de demanda y pedidos automáticos al proveedor
+// ----------------------------------------------------
+// Consume unidades de la existencia (FEFO) y las suma a la demanda del día
+// del insumo. O(1) además del costo de sacar los lotes.
+void registrar_consumo(Existencia* e, int cantidad) {
+    int consumidas = consumir_lotes(e, cantidad, NULL);
+    demanda_insumo(e)->consumo_hoy += consumidas;
+}
+
+// Cierra el día del insumo: actualiza promedio y desviación con el consumo de
+// hoy y recalcula el punto de pedido (demanda esperada de un día más el
+// stock de seguridad)
+void actualizar_pronostico(DemandaInsumo* d) {
+    double x = d->consumo_hoy;
+    if (d->dias == 0) {
+        d->promedio = x;
+        d->desviacion = 0;
+    } else {
+        double error = x - d->promedio;
+        if (error < 0) error = -error;
+        d->desviacion = ALFA_DEMANDA * error + (1 - ALFA_DEMANDA) * d->desviacion;
+        d->promedio   = ALFA_DEMANDA * x + (1 - ALFA_DEMANDA) * d->promedio;
+    }
+    d->dias++;
+    d->consumo_hoy = 0;
+    d->punto_pedido = (int)(d->promedio + FACTOR_SEGURIDAD * d->desviacion + 0.999);
+}
+
+// Una pasada por el catálogo: cada insumo cuyo stock en el hospital quedó en
+// o bajo su punto de pedido recibe en Bodega un lote que lo repone hasta
+// cubrir DIAS_COBERTURA días más (sin pasar de TOPE_BODEGA en Bodega).
+// Devuelve el total de unidades pedidas.
+int generar_pedidos_automaticos(TablaSalas* salas) {
+    Sala* bodega = sala_bodega(salas);
+    int total = 0;
+    for (int k = 0; k < catalogo.cantidad; k++) {
+        DemandaInsumo* d = &catalogo.demanda[k];
+        actualizar_pronostico(d);
+        d->cantidad_pedido = 0;
+        if (!bodega || d->promedio <= 0 || d->stock > d->punto_pedido) continue;
+
+        Insumo* ins = catalogo.insumos[k];
+        int objetivo = d->punto_pedido + (int)(d->promedio * DIAS_COBERTURA + 0.999);
+        int pedido = objetivo - d->stock;
+        StockDiario* sd = stock_bodega(bodega, ins);
+        if (!sd) continue;
+        if (sd->cantidad_total + pedido > TOPE_BODEGA) pedido = TOPE_BODEGA - sd->cantidad_total;
+        if (pedido <= 0) continue;
+
+        Existencia* e = buscar_insumo(bodega, ins->id);
+        agregar_lote(e, vence_reposicion(ins), pedido);
+        sd->cantidad_total = e->cantidad;
+        d->cantidad_pedido = pedido;
+        total += pedido;
+        printf("  Pedido automatico: %d %s de '%s' (ID %d), demanda %.1f/dia, punto de pedido %d.\n",
+               pedido, texto_simbolo(ins->unidad), ins->nombre, ins->id, d->promedio, d->punto_pedido);
+    }
+    return total;
+}
+
+// ----------------------------------------------------
+// Retirar los lotes vencidos de todas las salas
+// ----------------------------------------------------
+// Por cada existencia sólo se revisa el lote que vence primero; los que ya
+// vencieron se sacan del heap. En las salas clínicas se quitan las
+// existencias que quedan en cero y en Bodega se ajusta su StockDiario.
+int retirar_insumos_vencidos(TablaSalas* salas) {
+    int hoy = fecha_hoy();
+    int total = 0;
+    for (int id = 0; id < salas->cantidad; id++) {
+        Sala* s = &salas->salas[id];
+        for (int k = s->num_insumos - 1; k >= 0; k--) {
+            Existencia* e = &s->insumos[k];
+            if (proximo_vencimiento(e) > hoy) continue;
+
+            Insumo* ins = ficha_insumo(e);
+            int vencidas = purgar_vencidos(e, hoy);
+            total += vencidas;
+            printf("  %s: %d %s de '%s' (ID %d) vencieron.\n",
+                   s->nombre, vencidas, texto_simbolo(ins->unidad), ins->nombre, ins->id);
+
+            if (s->tipo == SALA_BODEGA) {
+                StockDiario* sd = buscar_stock(s, ins->id);
+                if (sd) sd->cantidad_total = e->cantidad;
+            } else if (e->cantidad == 0) {
+                quitar_insumo_sala(s, e);
+            }
+        }
+    }
+    return total;
 }
 
 // ----------------------------------------------------
 // Función principal del ciclo diario
 // ----------------------------------------------------
-void ciclo_diario() {
+// Abre un día nuevo con la llegada de pacientes; devuelve la cuota de retiro
+// de Bodega de ese día
+int comenzar_dia() {
     dia_actual++;
     printf("\n----- Comenzando Dia %d -----\n", dia_actual);
+    traza_marca("comienza_dia", "dia");
 
+    TRAZA_INICIO(llegadas);
     generar_pacientes_nuevos();
+    TRAZA_FIN(llegadas, "generar_pacientes_nuevos", "dia");
 
     int limite_retirar_diario = BASE_RETIRAR + reputacion * MULTIPLICADOR_REPUTACION;
-    if (limite_retirar_diario < 0) limite_retirar_diario = 0;
+    return limite_retirar_diario < 0 ? 0 : limite_retirar_diario;
+}
+
+void cerrar_dia() {
+    ejecutar_procesos_fin_dia();
+    publicar_vista();
+    exportar_metricas();
+    traza_volcar();
+}
+
+void ciclo_diario() {
+    int limite_retirar_diario = comenzar_dia();
 
     int opcion_dia;
     do {
+        publicar_vista();
         mostrar_encabezado();
 
         printf("\nMenu de Acciones - Dia %d (Limite diario de retiro: %d unidades)\n",
@@ -1177,82 +3265,839 @@ void ciclo_diario() {
         printf("4. Gestionar Bodega (Pedir o Distribuir insumos)\n");
         printf("5. Mostrar estadisticas (curados, fallecidos, reputacion)\n");
         printf("6. Finalizar Turno\n");
+        printf("7. Buscar pacientes\n");
         printf("Seleccione una opcion: ");
-        scanf("%d", &opcion_dia);
-        getchar();
+        opcion_dia = leer_opcion(6);
 
         switch (opcion_dia) {
             case 1:
-                limpiarPantalla();
-                mostrar_salas(salas_global);
-                presioneTeclaParaContinuar();
+                limpiar_pantalla();
+                mostrar_salas();
                 break;
             case 2:
-                limpiarPantalla();
+                limpiar_pantalla();
                 transferir_pacientes_menu(salas_global);
                 presioneTeclaParaContinuar();
                 break;
             case 3:
-                limpiarPantalla();
+                limpiar_pantalla();
                 atender_paciente(salas_global);
                 presioneTeclaParaContinuar();
                 break;
             case 4:
-                limpiarPantalla();
+                limpiar_pantalla();
                 gestionar_bodega(salas_global, &limite_retirar_diario);
                 presioneTeclaParaContinuar();
                 break;
             case 5:
-                limpiarPantalla();
+                limpiar_pantalla();
                 mostrar_estadisticas();
                 presioneTeclaParaContinuar();
                 break;
             case 6:
                 break;
+            case 7:
+                limpiar_pantalla();
+                buscar_pacientes_menu(salas_global);
+                presioneTeclaParaContinuar();
+                break;
             default:
                 printf("Opcion invalida.\n");
         }
     } while (opcion_dia != 6);
 
-    ejecutar_procesos_fin_dia();
+    cerrar_dia();
+}
+
+// ----------------------------------------------------
+// Lenguaje de comandos (gestor_hospital --comandos [archivo])
+// ----------------------------------------------------
+// Una orden por línea, sobre IDs en lugar de posiciones de menú:
+//   transfer <id_paciente> [sala]       desde Sala de Espera; sin sala, a su área
+//   cure <sala> <id_paciente>           cura a ese paciente
+//   cure <sala> all | cure all          cura en lote en una sala o en todas
+//   withdraw <id_insumo> <cantidad> <sala>
+//   distribute                          distribución optimizada desde Bodega
+//   endday                              cierra el día
+//   stats
+//   quit
+// El primer comando de cada día (salvo stats y quit) abre el día. Las líneas
+// vacías y las que empiezan con # se ignoran. Cada orden responde una línea
+// que empieza con "ok" o con "error"; los mensajes de la simulación se
+// siguen escribiendo aparte, como en los menús.
+static struct {
+    int dia_abierto;
+    int limite_retirar;   // cuota de retiro de Bodega que queda hoy
+} sesion;
+
+static void abrir_dia_sesion() {
+    if (sesion.dia_abierto) return;
+    sesion.limite_retirar = comenzar_dia();
+    sesion.dia_abierto = 1;
+}
+
+// Quita espacios al final y devuelve el texto sin espacios al comienzo
+static char* recortar(char* texto) {
+    while (*texto == ' ' || *texto == '\t') texto++;
+    size_t n = strlen(texto);
+    while (n > 0 && (texto[n - 1] == ' ' || texto[n - 1] == '\t' ||
+                     texto[n - 1] == '\n' || texto[n - 1] == '\r'))
+        texto[--n] = '\0';
+    return texto;
+}
+
+// Posición del paciente en la sala, o -1 si está en otra
+static int posicion_en_sala(Sala* sala, int h) {
+    return almacen.sala[h] == sala->id ? almacen.pos_sala[h] : -1;
+}
+
+static int comando_transfer(char* args, char* respuesta, size_t tam) {
+    int id, leidos = 0;
+    if (sscanf(args, "%d%n", &id, &leidos) != 1) {
+        snprintf(respuesta, tam, "error uso: transfer <id_paciente> [sala]");
+        return COMANDO_ERROR;
+    }
+    char* nombre = recortar(args + leidos);
+    int h = buscar_paciente(id);
+    Sala* espera = sala_espera(salas_global);
+    if (h < 0) {
+        snprintf(respuesta, tam, "error no existe el paciente %d", id);
+        return COMANDO_ERROR;
+    }
+    int pos = posicion_en_sala(espera, h);
+    if (pos < 0) {
+        snprintf(respuesta, tam, "error el paciente %d no esta en %s", id, espera->nombre);
+        return COMANDO_ERROR;
+    }
+    Sala* destino = *nombre ? buscar_sala(salas_global, nombre)
+                            : sala_por_id(salas_global, ficha_paciente(h)->sala_area);
+    if (!destino || destino->tipo != SALA_CLINICA) {
+        snprintf(respuesta, tam, "error '%s' no es una sala clinica", *nombre ? nombre : "(area del paciente)");
+        return COMANDO_ERROR;
+    }
+    int movido = mover_desde_espera(salas_global, pos, destino);
+    if (movido <= 0) {
+        if (movido < 0) snprintf(respuesta, tam, "error sin memoria");
+        else snprintf(respuesta, tam, "error %s esta llena", destino->nombre);
+        return COMANDO_ERROR;
+    }
+    snprintf(respuesta, tam, "ok transfer %d %s", id, destino->nombre);
+    return COMANDO_OK;
+}
+
+static int comando_cure(char* args, char* respuesta, size_t tam) {
+    // El último argumento es el ID (o all); lo anterior es el nombre de la sala
+    char* objetivo = strrchr(args, ' ');
+    if (objetivo) *objetivo++ = '\0';
+    else objetivo = args;
+    char* nombre = objetivo == args ? "" : recortar(args);
+
+    Sala* sala = NULL;
+    if (*nombre) {
+        sala = buscar_sala(salas_global, nombre);
+        if (!sala || sala->tipo != SALA_CLINICA) {
+            snprintf(respuesta, tam, "error '%s' no es una sala clinica", nombre);
+            return COMANDO_ERROR;
+        }
+    }
+
+    if (strcmp(objetivo, "all") == 0) {
+        int antes = pacientes_curados;
+        curar_pacientes_lote(salas_global, sala);
+        snprintf(respuesta, tam, "ok cure %s %d", sala ? sala->nombre : "all",
+                 pacientes_curados - antes);
+        return COMANDO_OK;
+    }
+
+    char* fin;
+    int id = (int)strtol(objetivo, &fin, 10);
+    if (!sala || *objetivo == '\0' || *fin != '\0') {
+        snprintf(respuesta, tam, "error uso: cure <sala> <id_paciente>|all");
+        return COMANDO_ERROR;
+    }
+    int h = buscar_paciente(id);
+    int pos = h < 0 ? -1 : posicion_en_sala(sala, h);
+    if (pos < 0) {
+        snprintf(respuesta, tam, "error el paciente %d no esta en %s", id, sala->nombre);
+        return COMANDO_ERROR;
+    }
+    int insumo = almacen.insumo_req_id[h];
+    switch (curar_paciente(sala, pos)) {
+        case CURA_SIN_INSUMO:
+            snprintf(respuesta, tam, "error %s no tiene el insumo %d", sala->nombre, insumo);
+            return COMANDO_ERROR;
+        case CURA_STOCK_INSUFICIENTE:
+            snprintf(respuesta, tam, "error stock insuficiente del insumo %d en %s", insumo, sala->nombre);
+            return COMANDO_ERROR;
+    }
+    snprintf(respuesta, tam, "ok cure %s %d", sala->nombre, id);
+    return COMANDO_OK;
+}
+
+static int comando_withdraw(char* args, char* respuesta, size_t tam) {
+    int id, cantidad, leidos = 0;
+    if (sscanf(args, "%d %d%n", &id, &cantidad, &leidos) != 2) {
+        snprintf(respuesta, tam, "error uso: withdraw <id_insumo> <cantidad> <sala>");
+        return COMANDO_ERROR;
+    }
+    char* nombre = recortar(args + leidos);
+    Sala* bodega = sala_bodega(salas_global);
+    StockDiario* sd = bodega ? buscar_stock(bodega, id) : NULL;
+    if (!sd || sd->cantidad_total <= 0) {
+        snprintf(respuesta, tam, "error no hay insumo %d en bodega", id);
+        return COMANDO_ERROR;
+    }
+    Sala* destino = buscar_sala(salas_global, nombre);
+    if (!destino || destino->tipo != SALA_CLINICA) {
+        snprintf(respuesta, tam, "error '%s' no es una sala clinica", nombre);
+        return COMANDO_ERROR;
+    }
+    const char* error = validar_retiro(sd, cantidad, sesion.limite_retirar);
+    if (error) {
+        snprintf(respuesta, tam, "error %s", error);
+        return COMANDO_ERROR;
+    }
+
+    uint64_t inicio = metricas_ahora_ns();
+    retirar_de_bodega(bodega, sd, destino, cantidad, &sesion.limite_retirar);
+    histograma_desde(metricas.distribuir, inicio);
+    snprintf(respuesta, tam, "ok withdraw %d %d %s (cuota %d)", id, cantidad,
+             destino->nombre, sesion.limite_retirar);
+    return COMANDO_OK;
+}
+
+static int comando_distribute(char* respuesta, size_t tam) {
+    int antes = sesion.limite_retirar;
+    uint64_t inicio = metricas_ahora_ns();
+    TRAZA_INICIO(traza);
+    distribuir_insumos_optimizado(salas_global, &sesion.limite_retirar);
+    histograma_desde(metricas.distribuir_optimizado, inicio);
+    TRAZA_FIN(traza, "distribuir_insumos_optimizado", "bodega");
+    snprintf(respuesta, tam, "ok distribute %d (cuota %d)", antes - sesion.limite_retirar,
+             sesion.limite_retirar);
+    return COMANDO_OK;
+}
+
+// Ejecuta una línea y deja en respuesta una línea (sin salto) para quien la
+// envió; devuelve COMANDO_OK, COMANDO_ERROR, COMANDO_SALIR o COMANDO_VACIO.
+// La línea se modifica al separar los argumentos.
+int ejecutar_comando(char* linea, char* respuesta, size_t tam) {
+    char* texto = recortar(linea);
+    respuesta[0] = '\0';
+    if (*texto == '\0' || *texto == '#') return COMANDO_VACIO;
+
+    char* args = texto + strcspn(texto, " \t");
+    if (*args) *args++ = '\0';
+    args = recortar(args);
+
+    if (strcmp(texto, "quit") == 0) {
+        snprintf(respuesta, tam, "ok quit");
+        return COMANDO_SALIR;
+    }
+    if (strcmp(texto, "stats") == 0) {
+        // antes de abrir el primer día la cuota todavía no está fijada: "-"
+        Sala* espera = sala_espera(salas_global);
+        char cuota[16] = "-";
+        if (sesion.dia_abierto) snprintf(cuota, sizeof(cuota), "%d", sesion.limite_retirar);
+        snprintf(respuesta, tam, "ok dia %d curados %d fallecidos %d reputacion %d espera %d cuota %s",
+                 dia_actual, pacientes_curados, pacientes_fallecidos, reputacion,
+                 espera ? espera->num_pacientes : 0, cuota);
+        return COMANDO_OK;
+    }
+
+    int (*orden)(char*, char*, size_t) = NULL;
+    if (strcmp(texto, "transfer") == 0) orden = comando_transfer;
+    else if (strcmp(texto, "cure") == 0) orden = comando_cure;
+    else if (strcmp(texto, "withdraw") == 0) orden = comando_withdraw;
+    else if (strcmp(texto, "distribute") != 0 && strcmp(texto, "endday") != 0) {
+        snprintf(respuesta, tam, "error comando desconocido '%s'", texto);
+        return COMANDO_ERROR;
+    }
+
+    abrir_dia_sesion();
+    if (orden) return orden(args, respuesta, tam);
+    if (strcmp(texto, "distribute") == 0) return comando_distribute(respuesta, tam);
+
+    cerrar_dia();
+    sesion.dia_abierto = 0;
+    snprintf(respuesta, tam, "ok endday %d curados %d fallecidos %d reputacion %d",
+             dia_actual, pacientes_curados, pacientes_fallecidos, reputacion);
+    return COMANDO_OK;
+}
+
+// Lee y ejecuta comandos hasta quit o el fin de la entrada; devuelve cuántos
+// terminaron en error
+int procesar_comandos(FILE* entrada) {
+    char linea[512];
+    char respuesta[256];
+    int errores = 0;
+    while (fgets(linea, sizeof(linea), entrada)) {
+        int resultado = ejecutar_comando(linea, respuesta, sizeof(respuesta));
+        if (resultado == COMANDO_VACIO) continue;
+        printf("%s\n", respuesta);
+        if (resultado == COMANDO_ERROR) errores++;
+        if (resultado == COMANDO_SALIR) break;
+    }
+    return errores;
+}
+
+// ----------------------------------------------------
+// Panel (HOSPITAL_PANEL=archivo): lector de vistas en su propio hilo
+// ----------------------------------------------------
+// Reescribe el archivo con el encabezado, las estadísticas y las salas cada
+// vez que hay una vista nueva (revisa cada periodo_ms). Nunca toca las salas
+// ni espera a la simulación: lee la última vista publicada.
+static struct {
+    pthread_t hilo;
+    const char* ruta;
+    int periodo_ms;
+    int lector;            // espacio en vistas, reservado al iniciar el panel
+    atomic_int activo;
+} panel;
+
+static void* ciclo_panel(void* arg) {
+    (void)arg;
+    traza_nombrar_hilo("panel");
+    int lector = panel.lector;
+    char temporal[PATH_MAX];
+    snprintf(temporal, sizeof(temporal), "%s.tmp", panel.ruta);
+    long escrita = 0;
+    Texto* pantalla = texto_crear(4096);
+
+    while (lector >= 0 && pantalla && atomic_load(&panel.activo)) {
+        const VistaHospital* v = publicacion_leer(vistas, lector);
+        if (v && v->version != escrita) {
+            TRAZA_INICIO(traza);
+            FILE* f = fopen(temporal, "w");
+            if (f) {
+                escribir_encabezado(f, v);
+                escribir_estadisticas(f, v);
+                texto_salas(pantalla, v);
+                texto_volcar(pantalla, f);
+                fclose(f);
+                // Quien mira el archivo nunca lo ve a medias
+                rename(temporal, panel.ruta);
+                escrita = v->version;
+            }
+            TRAZA_FIN(traza, "escribir_panel", "panel");
+        }
+        publicacion_terminar_lectura(vistas, lector);
+
+        // Se duerme en tramos cortos para notar enseguida detener_panel
+        for (int ms = 0; ms < panel.periodo_ms && atomic_load(&panel.activo); ms += 20) {
+            int tramo = panel.periodo_ms - ms < 20 ? panel.periodo_ms - ms : 20;
+            struct timespec espera = {0, tramo * 1000000L};
+            nanosleep(&espera, NULL);
+        }
+    }
+    if (lector >= 0) publicacion_soltar_lector(vistas, lector);
+    texto_destruir(pantalla);
+    return NULL;
+}
+
+int iniciar_panel(const char* ruta, int periodo_ms) {
+    // El lector se reserva antes de publicar: sin lectores no se arman vistas
+    if (!vistas) vistas = publicacion_crear(liberar_vista);
+    panel.lector = vistas ? publicacion_registrar_lector(vistas) : -1;
+    if (panel.lector < 0) return 0;
+    publicar_vista();
+    panel.ruta = ruta;
+    panel.periodo_ms = periodo_ms > 0 ? periodo_ms : 1000;
+    atomic_store(&panel.activo, 1);
+
+    // Las señales de término las atiende el hilo principal (el servidor las
+    // necesita para salir de epoll_wait): el panel nace con ellas bloqueadas
+    sigset_t bloqueadas, anteriores;
+    sigemptyset(&bloqueadas);
+    sigaddset(&bloqueadas, SIGINT);
+    sigaddset(&bloqueadas, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &bloqueadas, &anteriores);
+    int creado = pthread_create(&panel.hilo, NULL, ciclo_panel, NULL) == 0;
+    pthread_sigmask(SIG_SETMASK, &anteriores, NULL);
+    if (!creado) {
+        atomic_store(&panel.activo, 0);
+        publicacion_soltar_lector(vistas, panel.lector);
+    }
+    return creado;
+}
+
+// Espera a que el panel escriba la última vista y termine
+void detener_panel() {
+    if (!atomic_load(&panel.activo)) return;
+    publicar_vista();
+    atomic_store(&panel.activo, 0);
+    pthread_join(panel.hilo, NULL);
+}
+
+// ----------------------------------------------------
+// Salida asíncrona (HOSPITAL_SALIDA=directa la desactiva)
+// ----------------------------------------------------
+// Los menús y los mensajes de la simulación (transferencias, muertes, curas,
+// resumen del día) se siguen formateando con printf, pero stdout pasa a ser
+// un FILE que los encola en el anillo de tdas/escritor y un hilo aparte los
+// escribe en lotes: la simulación no espera a la terminal ni al disco. Con
+// una terminal se encola cada línea (y stdio vacía stdout antes de leer la
+// entrada, así que las preguntas aparecen a tiempo); si no, de a 16 KB.
+void iniciar_salida_asincrona() {
+    fflush(stdout);
+    salida.escritor = escritor_crear(STDOUT_FILENO, 1 << 18);
+    if (!salida.escritor) return;
+    FILE* flujo = escritor_flujo(salida.escritor, isatty(STDOUT_FILENO));
+    if (!flujo) {
+        escritor_destruir(salida.escritor);
+        salida.escritor = NULL;
+        return;
+    }
+    salida.original = stdout;
+    stdout = flujo;
+    atexit(terminar_salida_asincrona);
+}
+
+// Escribe lo pendiente y devuelve stdout a la biblioteca (se llama al salir)
+void terminar_salida_asincrona() {
+    if (!salida.escritor) return;
+    FILE* flujo = stdout;
+    stdout = salida.original;
+    fclose(flujo);
+    escritor_destruir(salida.escritor);
+    salida.escritor = NULL;
+}
+
+// ----------------------------------------------------
+// Pantalla en la terminal (tdas/pantalla)
+// ----------------------------------------------------
+// Cada pantalla de los menús es un cuadro: en lugar de borrar la terminal con
+// clear, se reescriben sólo las líneas que cambiaron respecto del cuadro
+// anterior, con secuencias ANSI que pasan por stdout como el resto del texto.
+// Si stdout no es una terminal (o TERM=dumb) la salida queda en texto plano.
+void iniciar_pantalla() {
+    const char* term = getenv("TERM");
+    if (!isatty(STDOUT_FILENO) || !term || strcmp(term, "dumb") == 0) return;
+    fflush(stdout);
+    salida.pantalla = pantalla_crear(stdout, STDOUT_FILENO);
+    if (!salida.pantalla) return;
+    salida.debajo = stdout;
+    stdout = pantalla_flujo(salida.pantalla);
+    atexit(terminar_pantalla);
+}
+
+void terminar_pantalla() {
+    if (!salida.pantalla) return;
+    FILE* flujo = stdout;
+    stdout = salida.debajo;
+    fclose(flujo);
+    pantalla_destruir(salida.pantalla);
+    salida.pantalla = NULL;
+}
+
+void limpiar_pantalla() {
+    if (salida.pantalla) pantalla_nuevo_cuadro(salida.pantalla);
+}
+
+// ----------------------------------------------------
+// Modo servidor (gestor_hospital --servidor ruta.sock)
+// ----------------------------------------------------
+// Varios operadores se conectan al socket y envían comandos del lenguaje de
+// arriba; todos actúan sobre el mismo hospital y el mismo día. El ciclo de
+// eventos de tdas/servidor.c es el único que toca el estado. quit cierra sólo
+// la conexión de quien lo envía; SIGINT o SIGTERM detienen el servidor.
+static int atender_linea_servidor(char* linea, char* respuesta, size_t tam, void* datos) {
+    (void)datos;
+    switch (ejecutar_comando(linea, respuesta, tam)) {
+        case COMANDO_VACIO: return SERVIDOR_SIN_RESPUESTA;
+        case COMANDO_SALIR: return SERVIDOR_CERRAR;
+        default:            return SERVIDOR_RESPONDER;
+    }
+}
+
+// Un lote de comandos es un turno: al terminarlo se publica la vista
+static void fin_lote_servidor(void* datos) {
+    (void)datos;
+    publicar_vista();
+}
+
+static void detener_servidor(int senal) {
+    (void)senal;
+    servidor_detener();
+}
+
+int atender_servidor(const char* ruta) {
+    Servidor* servidor = servidor_crear(ruta);
+    if (!servidor) return 0;
+
+    struct sigaction accion;
+    memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = detener_servidor;
+    sigaction(SIGINT, &accion, NULL);
+    sigaction(SIGTERM, &accion, NULL);
+
+    printf("Servidor escuchando en %s (Ctrl+C para terminar).\n", ruta);
+    fflush(stdout);
+    int resultado = servidor_ejecutar(servidor, atender_linea_servidor, fin_lote_servidor, NULL);
+    servidor_destruir(servidor);
+    printf("Servidor detenido.\n");
+    return resultado == 0;
+}
+
+// ----------------------------------------------------
+// Tiempo real (gestor_hospital --tiempo-real [segundos])
+// ----------------------------------------------------
+// El día se cierra solo cada tantos segundos de reloj (30 por defecto) y el
+// siguiente se abre enseguida, mientras el operador escribe comandos del
+// lenguaje de arriba: las muertes y las llegadas no esperan a que termine de
+// pensar. Un hilo de simulación es el único que toca el estado; el hilo
+// principal lee la entrada sin quedarse bloqueado (poll) y le pasa las líneas
+// completas por una cola. endday adelanta el cierre y vuelve a contar el
+// plazo. quit termina enseguida; el fin de la entrada, SIGINT o SIGTERM
+// terminan después de atender lo que ya estaba en la cola.
+typedef struct LineaPendiente {
+    struct LineaPendiente* siguiente;
+    uint64_t leida_ns;          // para medir cuánto esperó en la cola
+    char texto[];
+} LineaPendiente;
+
+static struct {
+    pthread_t hilo;
+    pthread_mutex_t cerrojo;    // protege la cola y los dos avisos
+    pthread_cond_t novedad;     // hay líneas nuevas o hay que terminar
+    LineaPendiente* primera;
+    LineaPendiente** ultima;
+    int sin_entrada;            // no llegan más líneas
+    int salir;                  // la simulación atendió quit
+    uint64_t periodo_ns;
+    int cierres;                // días cerrados por el reloj
+    int errores;
+} tiempo_real;
+
+static volatile sig_atomic_t tiempo_real_detenido = 0;
+
+static void detener_tiempo_real(int senal) {
+    (void)senal;
+    tiempo_real_detenido = 1;
+}
+
+static struct timespec instante_monotonico(uint64_t ns) {
+    struct timespec ts = {(time_t)(ns / 1000000000u), (long)(ns % 1000000000u)};
+    return ts;
+}
+
+// El reloj cierra el día y abre el siguiente, con sus llegadas
+static void cierre_automatico() {
+    abrir_dia_sesion();
+    cerrar_dia();
+    sesion.dia_abierto = 0;
+    tiempo_real.cierres++;
+    contador_sumar(metricas.cierres_automaticos, 1);
+    printf("Tiempo real: se cerro el dia %d; el siguiente cierre es en %.3g s.\n",
+           dia_actual, tiempo_real.periodo_ns / 1e9);
+    abrir_dia_sesion();
+}
+
+// Atiende un lote de líneas fuera del cerrojo; devuelve 1 si hubo un quit.
+// Las líneas después del quit se descartan.
+static int atender_lote_tiempo_real(LineaPendiente* lote, uint64_t* plazo) {
+    char respuesta[256];
+    int salir = 0;
+    while (lote) {
+        LineaPendiente* siguiente = lote->siguiente;
+        if (!salir) {
+            histograma_desde(metricas.espera_comando, lote->leida_ns);
+            int resultado = ejecutar_comando(lote->texto, respuesta, sizeof(respuesta));
+            if (resultado != COMANDO_VACIO) printf("%s\n", respuesta);
+            if (resultado == COMANDO_ERROR) tiempo_real.errores++;
+            if (resultado == COMANDO_SALIR) salir = 1;
+            // endday: el día siguiente empieza ya y con el plazo completo
+            if (!sesion.dia_abierto && !salir) {
+                abrir_dia_sesion();
+                *plazo = metricas_ahora_ns() + tiempo_real.periodo_ns;
+            }
+        }
+        MEM_FREE(lote);
+        lote = siguiente;
+    }
+    return salir;
+}
+
+static void* ciclo_simulacion(void* arg) {
+    (void)arg;
+    traza_nombrar_hilo("simulacion");
+    abrir_dia_sesion();
+    publicar_vista();
+    uint64_t plazo = metricas_ahora_ns() + tiempo_real.periodo_ns;
+
+    pthread_mutex_lock(&tiempo_real.cerrojo);
+    while (!tiempo_real.salir && (tiempo_real.primera || !tiempo_real.sin_entrada)) {
+        if (metricas_ahora_ns() >= plazo) {
+            pthread_mutex_unlock(&tiempo_real.cerrojo);
+            cierre_automatico();
+            publicar_vista();
+            // Si el cierre tardó más que el periodo no se acumulan cierres
+            plazo += tiempo_real.periodo_ns;
+            uint64_t ahora = metricas_ahora_ns();
+            if (plazo <= ahora) plazo = ahora + tiempo_real.periodo_ns;
+            pthread_mutex_lock(&tiempo_real.cerrojo);
+            continue;
+        }
+        if (!tiempo_real.primera) {
+            struct timespec limite = instante_monotonico(plazo);
+            pthread_cond_timedwait(&tiempo_real.novedad, &tiempo_real.cerrojo, &limite);
+            continue;
+        }
+        // Se lleva toda la cola: la entrada sigue encolando mientras se atiende
+        LineaPendiente* lote = tiempo_real.primera;
+        tiempo_real.primera = NULL;
+        tiempo_real.ultima = &tiempo_real.primera;
+        pthread_mutex_unlock(&tiempo_real.cerrojo);
+
+        TRAZA_INICIO(traza);
+        int salir = atender_lote_tiempo_real(lote, &plazo);
+        publicar_vista();
+        TRAZA_FIN(traza, "lote_comandos", "tiempo_real");
+
+        pthread_mutex_lock(&tiempo_real.cerrojo);
+        if (salir) tiempo_real.salir = 1;
+    }
+    pthread_mutex_unlock(&tiempo_real.cerrojo);
+    return NULL;
+}
+
+static void encolar_linea(const char* texto, size_t largo) {
+    LineaPendiente* l = (LineaPendiente*)MEM_MALLOC(sizeof(LineaPendiente) + largo + 1, MEM_TEMPORAL);
+    if (!l) return;
+    l->siguiente = NULL;
+    l->leida_ns = metricas_ahora_ns();
+    memcpy(l->texto, texto, largo);
+    l->texto[largo] = '\0';
+    pthread_mutex_lock(&tiempo_real.cerrojo);
+    *tiempo_real.ultima = l;
+    tiempo_real.ultima = &l->siguiente;
+    pthread_cond_signal(&tiempo_real.novedad);
+    pthread_mutex_unlock(&tiempo_real.cerrojo);
+}
+
+static int simulacion_terminada() {
+    pthread_mutex_lock(&tiempo_real.cerrojo);
+    int salir = tiempo_real.salir;
+    pthread_mutex_unlock(&tiempo_real.cerrojo);
+    return salir;
+}
+
+// Lee la entrada estándar con poll y encola sus líneas hasta que se acabe, se
+// pida quit o llegue SIGINT/SIGTERM. Se revisa cada 100 ms si la simulación
+// ya terminó, para no quedarse esperando una línea que no hace falta.
+static void leer_entrada_tiempo_real() {
+    char entrada[512];          // como procesar_comandos
+    size_t usados = 0;
+    int descartando = 0;        // resto de una línea demasiado larga
+    int fin = 0;
+    while (!fin && !tiempo_real_detenido && !simulacion_terminada()) {
+        struct pollfd pfd = {.fd = STDIN_FILENO, .events = POLLIN};
+        int listos = poll(&pfd, 1, 100);
+        if (listos < 0 && errno != EINTR) break;
+        if (listos <= 0) continue;
+
+        ssize_t n = read(STDIN_FILENO, entrada + usados, sizeof(entrada) - usados);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            fin = 1;            // la última línea puede no tener salto
+            n = 0;
+        }
+        usados += n;
+
+        size_t inicio = 0;
+        char* salto;
+        while ((salto = memchr(entrada + inicio, '\n', usados - inicio)) != NULL) {
+            size_t largo = salto - (entrada + inicio);
+            if (!descartando) encolar_linea(entrada + inicio, largo);
+            descartando = 0;
+            inicio += largo + 1;
+        }
+        memmove(entrada, entrada + inicio, usados - inicio);
+        usados -= inicio;
+        if (usados == sizeof(entrada)) {
+            if (!descartando) printf("error linea demasiado larga\n");
+            descartando = 1;
+            usados = 0;
+        }
+        if (fin && usados > 0 && !descartando) encolar_linea(entrada, usados);
+    }
+}
+
+int atender_tiempo_real(double segundos) {
+    if (segundos <= 0) segundos = 30;
+    tiempo_real.periodo_ns = (uint64_t)(segundos * 1e9);
+    tiempo_real.primera = NULL;
+    tiempo_real.ultima = &tiempo_real.primera;
+    pthread_mutex_init(&tiempo_real.cerrojo, NULL);
+    // El plazo se mide con el reloj monotónico, como las métricas
+    pthread_condattr_t atributos;
+    pthread_condattr_init(&atributos);
+    pthread_condattr_setclock(&atributos, CLOCK_MONOTONIC);
+    pthread_cond_init(&tiempo_real.novedad, &atributos);
+    pthread_condattr_destroy(&atributos);
+
+    // Sin SA_RESTART: la señal saca a poll de la espera
+    struct sigaction accion;
+    memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = detener_tiempo_real;
+    sigaction(SIGINT, &accion, NULL);
+    sigaction(SIGTERM, &accion, NULL);
+
+    printf("Tiempo real: el dia se cierra solo cada %.3g s. Escriba comandos "
+           "(transfer, cure, withdraw, distribute, endday, stats, quit).\n", segundos);
+    fflush(stdout);
+
+    // Como el panel, la simulación nace con las señales de término bloqueadas
+    sigset_t bloqueadas, anteriores;
+    sigemptyset(&bloqueadas);
+    sigaddset(&bloqueadas, SIGINT);
+    sigaddset(&bloqueadas, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &bloqueadas, &anteriores);
+    int creado = pthread_create(&tiempo_real.hilo, NULL, ciclo_simulacion, NULL) == 0;
+    pthread_sigmask(SIG_SETMASK, &anteriores, NULL);
+    if (!creado) {
+        printf("No se pudo iniciar el hilo de simulacion.\n");
+        return 0;
+    }
+
+    leer_entrada_tiempo_real();
+    pthread_mutex_lock(&tiempo_real.cerrojo);
+    tiempo_real.sin_entrada = 1;
+    pthread_cond_signal(&tiempo_real.novedad);
+    pthread_mutex_unlock(&tiempo_real.cerrojo);
+    pthread_join(tiempo_real.hilo, NULL);
+
+    // Lo que quedó en la cola después de un quit no se atiende
+    while (tiempo_real.primera) {
+        LineaPendiente* siguiente = tiempo_real.primera->siguiente;
+        MEM_FREE(tiempo_real.primera);
+        tiempo_real.primera = siguiente;
+    }
+    pthread_cond_destroy(&tiempo_real.novedad);
+    pthread_mutex_destroy(&tiempo_real.cerrojo);
+    printf("Tiempo real terminado: %d dias cerrados por el reloj, %d comandos con error.\n",
+           tiempo_real.cierres, tiempo_real.errores);
+    return 1;
 }
 
 // ----------------------------------------------------
-// Función main
+// Función main (los benchmarks incluyen este archivo con GESTOR_SIN_MAIN)
 // ----------------------------------------------------
-int main() {
-    srand(time(NULL));
+#ifndef GESTOR_SIN_MAIN
+int main(int argc, char** argv) {
+    // --comandos [archivo]: lee órdenes del archivo (o de la entrada estándar)
+    // en lugar de mostrar los menús; --servidor ruta: las recibe por un socket;
+    // --tiempo-real [segundos]: las lee mientras el día se cierra solo
+    int modo_comandos = argc > 1 && strcmp(argv[1], "--comandos") == 0;
+    const char* ruta_socket = argc > 2 && strcmp(argv[1], "--servidor") == 0 ? argv[2] : NULL;
+    int modo_tiempo_real = argc > 1 && strcmp(argv[1], "--tiempo-real") == 0;
+    double segundos_por_dia = modo_tiempo_real && argc > 2 ? atof(argv[2]) : 30;
+    if (argc > 1 && strcmp(argv[1], "--servidor") == 0 && !ruta_socket) {
+        fprintf(stderr, "Uso: %s --servidor ruta.sock\n", argv[0]);
+        return 1;
+    }
+#ifndef __linux__
+    // tdas/servidor usa epoll: fuera de Linux servidor_crear siempre falla
+    if (ruta_socket) {
+        fprintf(stderr, "El modo servidor no esta disponible en este sistema (requiere Linux).\n");
+        return 1;
+    }
+#endif
+    FILE* entrada_comandos = stdin;
+    if (modo_comandos && argc > 2 && strcmp(argv[2], "-") != 0) {
+        entrada_comandos = fopen(argv[2], "r");
+        if (!entrada_comandos) {
+            perror("Error al abrir el archivo de comandos");
+            return 1;
+        }
+    }
 
-    // Inicializar salas
-    salas_global = inicializar_salas();
+    const char* modo_salida = getenv("HOSPITAL_SALIDA");
+    if (!modo_salida || strcmp(modo_salida, "directa") != 0) iniciar_salida_asincrona();
+    iniciar_pantalla();
+
+    // HOSPITAL_SEMILLA fija la semilla para poder repetir una corrida
+    const char* semilla = getenv("HOSPITAL_SEMILLA");
+    srand(semilla && *semilla ? (unsigned)strtoul(semilla, NULL, 10) : (unsigned)time(NULL));
+
+    // Inicializar salas desde la configuración
+    FILE* archivo_salas = fopen("salas.csv", "r");
+    if (!archivo_salas) {
+        perror("Error al abrir salas.csv");
+        return 1;
+    }
+    salas_global = leer_salas(archivo_salas);
+    fclose(archivo_salas);
+    if (!salas_global) {
+        printf("Error de memoria al leer salas.csv.\n");
+        return 1;
+    }
+    if (salas_global->id_espera < 0) {
+        printf("La configuracion de salas debe incluir una sala de tipo Espera.\n");
+        return 1;
+    }
+    inicializar_indices();
+    inicializar_metricas();
+
+    // HOSPITAL_METRICAS=metricas.prom exporta las métricas al cerrar cada día
+    const char* ruta_metricas = getenv("HOSPITAL_METRICAS");
+    if (ruta_metricas && *ruta_metricas) metricas.archivo = ruta_metricas;
+
+    // HOSPITAL_TRAZA=traza.json guarda la línea de tiempo de cada día
+    const char* ruta_traza = getenv("HOSPITAL_TRAZA");
+    if (ruta_traza && *ruta_traza) {
+        if (traza_iniciar(ruta_traza)) traza_nombrar_hilo("principal");
+        else perror("Error al abrir el archivo de traza");
+    }
 
     // Cargar datos iniciales
     FILE* archivo_pac = fopen("pacientes.csv", "r");
     FILE* archivo_ins = fopen("insumos.csv", "r");
-    if (!archivo_pac || !archivo_ins) {
-        perror("Error al abrir pacientes o insumos");
+    FILE* archivo_trat = fopen("tratamientos.csv", "r");
+    if (!archivo_pac || !archivo_ins || !archivo_trat) {
+        perror("Error al abrir pacientes, insumos o tratamientos");
         if (archivo_pac) fclose(archivo_pac);
         if (archivo_ins) fclose(archivo_ins);
+        if (archivo_trat) fclose(archivo_trat);
         return 1;
     }
     List* pacientes = leer_pacientes(archivo_pac);
     List* insumos = leer_insumos(archivo_ins);
+    leer_tratamientos(archivo_trat);
     fclose(archivo_pac);
     fclose(archivo_ins);
+    fclose(archivo_trat);
 
     asignar_pacientes_a_espera(pacientes, salas_global);
     asignar_insumos_a_salas(insumos, salas_global);
 
     printf("Datos cargados correctamente.\n");
 
-    int opcion_principal;
-    do {
+    // HOSPITAL_PANEL=archivo mantiene ahí el estado del hospital, escrito por
+    // otro hilo (HOSPITAL_PANEL_MS: cada cuánto revisa si hay uno nuevo)
+    const char* ruta_panel = getenv("HOSPITAL_PANEL");
+    if (ruta_panel && *ruta_panel) {
+        const char* periodo = getenv("HOSPITAL_PANEL_MS");
+        if (!iniciar_panel(ruta_panel, periodo ? atoi(periodo) : 1000))
+            printf("No se pudo iniciar el panel.\n");
+    }
+
+    int opcion_principal = modo_comandos || ruta_socket || modo_tiempo_real ? 0 : -1;
+    if (modo_comandos) {
+        int errores = procesar_comandos(entrada_comandos);
+        if (entrada_comandos != stdin) fclose(entrada_comandos);
+        printf("Comandos terminados (%d con error).\n", errores);
+    } else if (ruta_socket && !atender_servidor(ruta_socket)) {
+        return 1;
+    } else if (modo_tiempo_real && !atender_tiempo_real(segundos_por_dia)) {
+        return 1;
+    }
+    while (opcion_principal != 0) {
         printf("\n=== GESTOR DE INSUMOS HOSPITALARIOS ===\n");
         printf("1. Comenzar Dia\n");
         printf("0. Salir\n");
         printf("Seleccione una opcion: ");
-        scanf("%d", &opcion_principal);
-        getchar();
+        opcion_principal = leer_opcion(0);
 
         switch (opcion_principal) {
             case 1:
@@ -1264,9 +4109,30 @@ int main() {
             default:
                 printf("Opcion invalida.\n");
         }
-    } while (opcion_principal != 0);
+    }
 
+    detener_panel();
+    publicacion_destruir(vistas);
+    vistas = NULL;
+
+    // Lo que sigue vivo al salir: las salas, el catálogo, los pacientes
+    // que quedan y sus índices
+    mem_report(stdout, "al salir (asignaciones vivas)");
+    traza_terminar();
+
+    // HOSPITAL_RESUMEN=archivo guarda el estado final (lo usa bench/golden.c)
+    const char* ruta_resumen = getenv("HOSPITAL_RESUMEN");
+    if (ruta_resumen && *ruta_resumen) {
+        FILE* resumen = fopen(ruta_resumen, "w");
+        if (resumen) {
+            escribir_resumen_estado(resumen);
+            fclose(resumen);
+        } else {
+            perror("Error al escribir el resumen");
+        }
+    }
     return 0;
 }
+#endif
 
 // CAMBIAR EL SISTEMA DE INGRESO POR DIA, QUITAR LA CREACION DE PACIENTES RANDOM Y HACER EL CSV DE PACIENTES MAS GRANDE.
@@ -0,0 +1,104 @@
+#include "arraylist.h"
+#include "memoria.h"
+#include "traza.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct ArrayList {
+  void **data;
+  int size;
+  int capac;
+};
+
+typedef ArrayList ArrayList;
+
+ArrayList *arraylist_create() {
+  ArrayList *newList = (ArrayList *)MEM_MALLOC(sizeof(ArrayList), MEM_ARREGLO);
+  if (newList == NULL) {
+    return NULL; // Fallo en la asignación de memoria
+  }
+  newList->capac = 8; // capacidad inicial
+  newList->data = (void **)MEM_MALLOC(newList->capac * sizeof(void *), MEM_ARREGLO);
+  if (newList->data == NULL) {
+    MEM_FREE(newList);
+    return NULL;
+  }
+  newList->size = 0;
+  return newList;
+}
+
+int arraylist_size(ArrayList *A) { return A ? A->size : 0; }
+
+void *arraylist_get(ArrayList *A, int i) {
+  if (A == NULL || i < 0 || i >= A->size) {
+    return NULL; // Posición fuera de rango
+  }
+  return A->data[i];
+}
+
+void arraylist_set(ArrayList *A, int i, void *data) {
+  if (A == NULL || i < 0 || i >= A->size) {
+    return;
+  }
+  A->data[i] = data;
+}
+
+void arraylist_pushBack(ArrayList *A, void *data) {
+  if (A == NULL) {
+    return; // Lista no inicializada
+  }
+  if (A->size == A->capac) {
+    int nueva = A->capac * 2;
+    void **nuevo = (void **)MEM_REALLOC(A->data, nueva * sizeof(void *), MEM_ARREGLO);
+    if (nuevo == NULL) {
+      return; // Fallo en la asignación de memoria
+    }
+    A->data = nuevo;
+    A->capac = nueva;
+  }
+  A->data[A->size++] = data;
+}
+
+void *arraylist_remove(ArrayList *A, int i) {
+  if (A == NULL || i < 0 || i >= A->size) {
+    return NULL;
+  }
+  void *data = A->data[i];
+  memmove(&A->data[i], &A->data[i + 1], (A->size - i - 1) * sizeof(void *));
+  A->size--;
+  return data;
+}
+
+int arraylist_indexOf(ArrayList *A, void *data) {
+  if (A == NULL) {
+    return -1;
+  }
+  for (int i = 0; i < A->size; i++) {
+    if (A->data[i] == data) return i;
+  }
+  return -1;
+}
+
+void arraylist_truncate(ArrayList *A, int n) {
+  if (A == NULL || n < 0 || n > A->size) {
+    return;
+  }
+  A->size = n;
+}
+
+void arraylist_sort(ArrayList *A, int (*cmp)(const void *a, const void *b)) {
+  if (A == NULL || A->size < 2) {
+    return;
+  }
+  TRAZA_INICIO(inicio);
+  qsort(A->data, A->size, sizeof(void *), cmp);
+  TRAZA_FIN(inicio, "arraylist_sort", "tda");
+}
+
+void arraylist_clean(ArrayList *A) {
+  if (A == NULL) {
+    return;
+  }
+  A->size = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef ARRAYLIST_H
+#define ARRAYLIST_H
+
+// Lista respaldada por un arreglo dinámico: acceso por posición en O(1).
+
+typedef struct ArrayList ArrayList;
+
+// Esta función crea una lista vacía y devuelve un puntero a la lista.
+ArrayList *arraylist_create();
+
+// Esta función devuelve la cantidad de elementos de la lista.
+int arraylist_size(ArrayList *A);
+
+// Esta función devuelve el elemento en la posición i (0..size-1) o NULL.
+void *arraylist_get(ArrayList *A, int i);
+
+// Esta función reemplaza el elemento en la posición i.
+void arraylist_set(ArrayList *A, int i, void *data);
+
+// Esta función inserta un nuevo elemento al final de la lista.
+void arraylist_pushBack(ArrayList *A, void *data);
+
+// Esta función elimina el elemento en la posición i, conservando el orden del
+// resto, y lo devuelve.
+void *arraylist_remove(ArrayList *A, int i);
+
+// Esta función devuelve la posición del elemento (comparando punteros) o -1.
+int arraylist_indexOf(ArrayList *A, void *data);
+
+// Esta función deja sólo los primeros n elementos (para compactar la lista
+// después de recorrerla con arraylist_set).
+void arraylist_truncate(ArrayList *A, int n);
+
+// Esta función ordena la lista con qsort; la función de comparación recibe
+// punteros a los elementos (void **), como en qsort.
+void arraylist_sort(ArrayList *A, int (*cmp)(const void *a, const void *b));
+
+// Esta función elimina todos los elementos de la lista.
+void arraylist_clean(ArrayList *A);
+
+#endif
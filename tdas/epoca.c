@@ -0,0 +1,126 @@
+#include "epoca.h"
+#include "memoria.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Cada lector anuncia en su espacio la época en que empezó a leer (0 si no
+// está leyendo). Al publicar, el dato reemplazado queda retirado con la
+// época vigente y la época avanza: un lector que lo haya tomado anunció una
+// época menor o igual, así que se puede liberar cuando todos los lectores
+// activos anuncian una época mayor.
+
+typedef struct {
+  _Atomic uint64_t epoca;
+  atomic_int en_uso;
+  char relleno[64 - sizeof(uint64_t) - sizeof(int)]; // una línea de caché por lector
+} EspacioLector;
+
+typedef struct Retirado {
+  void *dato;
+  uint64_t epoca;
+  struct Retirado *siguiente;
+} Retirado;
+
+struct Publicacion {
+  _Atomic(void *) actual;
+  _Atomic uint64_t epoca;
+  void (*liberar)(void *);
+  Retirado *retirados;           // sólo los toca el escritor
+  EspacioLector lectores[MAX_LECTORES];
+};
+
+Publicacion *publicacion_crear(void (*liberar)(void *)) {
+  Publicacion *p = (Publicacion *)MEM_CALLOC(1, sizeof(Publicacion), MEM_VISTA);
+  if (p == NULL) return NULL;
+  atomic_init(&p->actual, NULL);
+  atomic_init(&p->epoca, 1);
+  p->liberar = liberar;
+  return p;
+}
+
+// Libera los retirados antes de la época más antigua que sigue leyendo
+static void recolectar(Publicacion *p) {
+  uint64_t minima = UINT64_MAX;
+  for (int i = 0; i < MAX_LECTORES; i++) {
+    uint64_t e = atomic_load(&p->lectores[i].epoca);
+    if (e != 0 && e < minima) minima = e;
+  }
+  Retirado **r = &p->retirados;
+  while (*r != NULL) {
+    if ((*r)->epoca < minima) {
+      Retirado *libre = *r;
+      *r = libre->siguiente;
+      p->liberar(libre->dato);
+      MEM_FREE(libre);
+    } else {
+      r = &(*r)->siguiente;
+    }
+  }
+}
+
+void publicacion_publicar(Publicacion *p, void *dato) {
+  void *anterior = atomic_exchange(&p->actual, dato);
+  uint64_t epoca = atomic_fetch_add(&p->epoca, 1);
+  if (anterior != NULL) {
+    Retirado *r = (Retirado *)MEM_MALLOC(sizeof(Retirado), MEM_VISTA);
+    if (r == NULL) {
+      // Sin memoria para anotarlo es preferible perderlo que liberarlo antes
+      // de tiempo
+      recolectar(p);
+      return;
+    }
+    r->dato = anterior;
+    r->epoca = epoca;
+    r->siguiente = p->retirados;
+    p->retirados = r;
+  }
+  recolectar(p);
+}
+
+void *publicacion_actual(Publicacion *p) {
+  return atomic_load_explicit(&p->actual, memory_order_relaxed);
+}
+
+int publicacion_registrar_lector(Publicacion *p) {
+  for (int i = 0; i < MAX_LECTORES; i++) {
+    int libre = 0;
+    if (atomic_compare_exchange_strong(&p->lectores[i].en_uso, &libre, 1))
+      return i;
+  }
+  return -1;
+}
+
+void publicacion_soltar_lector(Publicacion *p, int lector) {
+  atomic_store(&p->lectores[lector].epoca, 0);
+  atomic_store(&p->lectores[lector].en_uso, 0);
+}
+
+int publicacion_lectores(Publicacion *p) {
+  int n = 0;
+  for (int i = 0; i < MAX_LECTORES; i++) n += atomic_load(&p->lectores[i].en_uso);
+  return n;
+}
+
+const void *publicacion_leer(Publicacion *p, int lector) {
+  // Primero se anuncia la época y después se toma el dato: si el escritor lo
+  // reemplaza en el medio, ya ve el anuncio al recolectar
+  atomic_store(&p->lectores[lector].epoca, atomic_load(&p->epoca));
+  return atomic_load(&p->actual);
+}
+
+void publicacion_terminar_lectura(Publicacion *p, int lector) {
+  atomic_store(&p->lectores[lector].epoca, 0);
+}
+
+void publicacion_destruir(Publicacion *p) {
+  if (p == NULL) return;
+  while (p->retirados != NULL) {
+    Retirado *r = p->retirados;
+    p->retirados = r->siguiente;
+    p->liberar(r->dato);
+    MEM_FREE(r);
+  }
+  void *actual = atomic_load(&p->actual);
+  if (actual != NULL) p->liberar(actual);
+  MEM_FREE(p);
+}
@@ -0,0 +1,54 @@
+#ifndef EPOCA_H
+#define EPOCA_H
+
+// Publicación de datos inmutables para lectores en otros hilos, con
+// liberación por épocas (al estilo RCU). Un único hilo escritor arma un dato
+// nuevo y lo publica; los lectores toman el último publicado sin locks y lo
+// pueden leer todo el tiempo que quieran. El dato reemplazado se libera recién
+// cuando ningún lector que pudo haberlo tomado sigue leyendo, así que ni el
+// escritor espera a los lectores ni los lectores al escritor.
+//
+// Uso desde un lector:
+//   int lector = publicacion_registrar_lector(p);
+//   const Dato *d = publicacion_leer(p, lector);
+//   ... usar d ...
+//   publicacion_terminar_lectura(p, lector);
+
+#define MAX_LECTORES 16
+
+typedef struct Publicacion Publicacion;
+
+// Esta función crea una publicación vacía. liberar se llama (en el hilo
+// escritor) con cada dato que ya nadie puede estar leyendo.
+Publicacion *publicacion_crear(void (*liberar)(void *dato));
+
+// Esta función publica dato, que desde ahora no debe modificarse, y libera
+// los datos anteriores que ya no tienen lectores. Sólo la llama el escritor.
+void publicacion_publicar(Publicacion *p, void *dato);
+
+// Esta función devuelve el último dato publicado. Sólo la llama el escritor:
+// el dato vigente nunca se libera, así que no necesita registrarse.
+void *publicacion_actual(Publicacion *p);
+
+// Esta función reserva un espacio de lector para un hilo lector (lo puede
+// reservar otro hilo antes de crearlo). Devuelve -1 si ya hay MAX_LECTORES
+// registrados.
+int publicacion_registrar_lector(Publicacion *p);
+
+void publicacion_soltar_lector(Publicacion *p, int lector);
+
+// Esta función devuelve cuántos lectores hay registrados, para que el
+// escritor no arme datos que nadie va a leer.
+int publicacion_lectores(Publicacion *p);
+
+// Esta función devuelve el último dato publicado (NULL si no hay ninguno). El
+// dato sigue siendo válido hasta publicacion_terminar_lectura.
+const void *publicacion_leer(Publicacion *p, int lector);
+
+void publicacion_terminar_lectura(Publicacion *p, int lector);
+
+// Esta función libera el dato vigente y los pendientes. No debe quedar ningún
+// lector leyendo.
+void publicacion_destruir(Publicacion *p);
+
+#endif /* EPOCA_H */
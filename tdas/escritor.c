@@ -0,0 +1,205 @@
+#define _GNU_SOURCE
+#include "escritor.h"
+#include "memoria.h"
+#include "traza.h"
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#define TAM_FLUJO 16384 // buffer de stdio del FILE de escritor_flujo
+
+// Anillo de bytes de un productor y un consumidor: el productor sólo avanza
+// cabeza y el hilo escritor sólo avanza cola; las dos crecen sin volver a 0 y
+// la posición en el anillo es el valor módulo la capacidad.
+struct Escritor {
+  int fd;
+  char *anillo;
+  size_t capacidad; // potencia de 2
+  _Atomic size_t cabeza;
+  char relleno1[64];
+  _Atomic size_t cola;
+  char relleno2[64];
+  atomic_uint aviso;    // futex: cambia cada vez que se despierta al hilo
+  atomic_int durmiendo; // el hilo escritor está esperando datos
+  atomic_int terminar;
+  atomic_long bytes, escrituras, esperas;
+  pthread_t hilo;
+};
+
+// Fuera de Linux no hay futex: el hilo dormido revisa aviso cada milisegundo
+static void futex_esperar(atomic_uint *dir, unsigned valor) {
+#ifdef __linux__
+  syscall(SYS_futex, dir, FUTEX_WAIT_PRIVATE, valor, NULL, NULL, 0);
+#else
+  struct timespec pausa = {0, 1000000};
+  while (atomic_load(dir) == valor) nanosleep(&pausa, NULL);
+#endif
+}
+
+static void futex_despertar(atomic_uint *dir) {
+#ifdef __linux__
+  syscall(SYS_futex, dir, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+  (void)dir;
+#endif
+}
+
+// El productor sólo hace una llamada al sistema si el hilo está dormido
+static void despertar(Escritor *e) {
+  if (atomic_load(&e->durmiendo)) {
+    atomic_fetch_add(&e->aviso, 1);
+    futex_despertar(&e->aviso);
+  }
+}
+
+// Escribe todo lo que hay entre cola y cabeza (en dos tramos si da la vuelta
+// al anillo) con una sola llamada cuando se puede
+static void escribir_pendiente(Escritor *e, size_t cola, size_t cabeza) {
+  TRAZA_INICIO(traza);
+  while (cola != cabeza) {
+    size_t inicio = cola & (e->capacidad - 1);
+    size_t n = cabeza - cola;
+    struct iovec partes[2];
+    int num_partes = 1;
+    partes[0].iov_base = e->anillo + inicio;
+    partes[0].iov_len = n;
+    if (inicio + n > e->capacidad) {
+      partes[0].iov_len = e->capacidad - inicio;
+      partes[1].iov_base = e->anillo;
+      partes[1].iov_len = n - partes[0].iov_len;
+      num_partes = 2;
+    }
+    ssize_t escritos = writev(e->fd, partes, num_partes);
+    if (escritos < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN) {
+        struct pollfd p = {.fd = e->fd, .events = POLLOUT};
+        poll(&p, 1, -1);
+        continue;
+      }
+      escritos = n; // el destino ya no acepta datos: se descartan
+    }
+    atomic_fetch_add(&e->escrituras, 1);
+    atomic_fetch_add(&e->bytes, escritos);
+    cola += escritos;
+    atomic_store(&e->cola, cola);
+  }
+  TRAZA_FIN(traza, "escribir_lote", "salida");
+}
+
+static void *ciclo_escritor(void *arg) {
+  Escritor *e = arg;
+  traza_nombrar_hilo("escritor");
+  for (;;) {
+    size_t cola = atomic_load(&e->cola);
+    size_t cabeza = atomic_load(&e->cabeza);
+    if (cola != cabeza) {
+      escribir_pendiente(e, cola, cabeza);
+      continue;
+    }
+    if (atomic_load(&e->terminar)) break;
+
+    // Se anuncia que se va a dormir y se vuelve a mirar: si el productor
+    // encoló en el medio, o ve el anuncio y cambia aviso, o el dato ya se ve
+    unsigned visto = atomic_load(&e->aviso);
+    atomic_store(&e->durmiendo, 1);
+    if (atomic_load(&e->cabeza) == cabeza && !atomic_load(&e->terminar))
+      futex_esperar(&e->aviso, visto);
+    atomic_store(&e->durmiendo, 0);
+  }
+  return NULL;
+}
+
+Escritor *escritor_crear(int fd, size_t capacidad) {
+  size_t tam = 4096;
+  while (tam < capacidad) tam *= 2;
+  Escritor *e = (Escritor *)MEM_CALLOC(1, sizeof(Escritor), MEM_OTRO);
+  if (e == NULL) return NULL;
+  e->anillo = (char *)MEM_MALLOC(tam, MEM_OTRO);
+  if (e->anillo == NULL) {
+    MEM_FREE(e);
+    return NULL;
+  }
+  e->fd = fd;
+  e->capacidad = tam;
+  if (pthread_create(&e->hilo, NULL, ciclo_escritor, e) != 0) {
+    MEM_FREE(e->anillo);
+    MEM_FREE(e);
+    return NULL;
+  }
+  return e;
+}
+
+void escritor_escribir(Escritor *e, const void *datos, size_t n) {
+  const char *bytes = datos;
+  size_t cabeza = atomic_load_explicit(&e->cabeza, memory_order_relaxed);
+  while (n > 0) {
+    size_t libre = e->capacidad - (cabeza - atomic_load(&e->cola));
+    if (libre == 0) {
+      // Anillo lleno: el destino va atrasado, hay que esperarlo
+      atomic_fetch_add(&e->esperas, 1);
+      despertar(e);
+      struct timespec pausa = {0, 100000};
+      nanosleep(&pausa, NULL);
+      continue;
+    }
+    size_t k = n < libre ? n : libre;
+    size_t inicio = cabeza & (e->capacidad - 1);
+    size_t primero = k < e->capacidad - inicio ? k : e->capacidad - inicio;
+    memcpy(e->anillo + inicio, bytes, primero);
+    memcpy(e->anillo, bytes + primero, k - primero);
+    cabeza += k;
+    bytes += k;
+    n -= k;
+    atomic_store(&e->cabeza, cabeza);
+    despertar(e);
+  }
+}
+
+#ifdef __GLIBC__
+static ssize_t escribir_flujo(void *cookie, const char *datos, size_t n) {
+  escritor_escribir(cookie, datos, n);
+  return n;
+}
+
+FILE *escritor_flujo(Escritor *e, int linea) {
+  cookie_io_functions_t funciones = {.write = escribir_flujo};
+  FILE *f = fopencookie(e, "w", funciones);
+  if (f) setvbuf(f, NULL, linea ? _IOLBF : _IOFBF, TAM_FLUJO);
+  return f;
+}
+#else
+// fopencookie es de glibc: sin ella quien llama sigue con stdio común
+FILE *escritor_flujo(Escritor *e, int linea) {
+  (void)e;
+  (void)linea;
+  return NULL;
+}
+#endif
+
+void escritor_estadisticas(Escritor *e, long *bytes, long *escrituras,
+                           long *esperas) {
+  if (bytes) *bytes = atomic_load(&e->bytes);
+  if (escrituras) *escrituras = atomic_load(&e->escrituras);
+  if (esperas) *esperas = atomic_load(&e->esperas);
+}
+
+void escritor_destruir(Escritor *e) {
+  if (e == NULL) return;
+  atomic_store(&e->terminar, 1);
+  atomic_fetch_add(&e->aviso, 1);
+  futex_despertar(&e->aviso);
+  pthread_join(e->hilo, NULL);
+  MEM_FREE(e->anillo);
+  MEM_FREE(e);
+}
@@ -0,0 +1,39 @@
+#ifndef ESCRITOR_H
+#define ESCRITOR_H
+#include <stddef.h>
+#include <stdio.h>
+
+// Escritor asíncrono sobre un descriptor (terminal, archivo, tubería). Quien
+// produce copia bytes ya formateados a un anillo sin locks y sigue; un hilo
+// aparte los junta y los escribe con la menor cantidad posible de llamadas a
+// write. El productor sólo espera si el anillo se llena, es decir, si el
+// destino no da abasto por más de lo que cabe en él.
+//
+// El anillo tiene un solo productor: si varios hilos escriben, tienen que
+// turnarse (el FILE de escritor_flujo ya lo hace con su propio lock).
+
+typedef struct Escritor Escritor;
+
+// Esta función crea el escritor y su hilo. capacidad se redondea a una
+// potencia de 2. Devuelve NULL si falla.
+Escritor *escritor_crear(int fd, size_t capacidad);
+
+// Esta función encola n bytes. No espera a que se escriban.
+void escritor_escribir(Escritor *e, const void *datos, size_t n);
+
+// Esta función devuelve un FILE cuyo contenido se encola en el escritor, para
+// usarlo con fprintf o en lugar de stdout. linea indica si se vacía en cada
+// salto de línea (para una terminal) o al llenarse su buffer. Devuelve NULL
+// si falla o fuera de glibc, que es la que tiene fopencookie.
+FILE *escritor_flujo(Escritor *e, int linea);
+
+// Esta función devuelve cuántos bytes y cuántas llamadas a write lleva el
+// escritor, y cuántas veces el productor encontró el anillo lleno.
+void escritor_estadisticas(Escritor *e, long *bytes, long *escrituras,
+                           long *esperas);
+
+// Esta función escribe lo pendiente, termina el hilo y libera el escritor. El
+// FILE de escritor_flujo debe cerrarse antes.
+void escritor_destruir(Escritor *e);
+
+#endif /* ESCRITOR_H */
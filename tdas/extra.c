@@ -1,4 +1,11 @@
 #include "extra.h"
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define STDOUT_FILENO 1
+#else
+#include <unistd.h>
+#endif
 
 
 #define MAX_LINE_LENGTH 4096
@@ -93,11 +100,19 @@ List *split_string(const char *str, const char *delim) {
   return result;
 }
 
-// Función para limpiar la pantalla
-void limpiarPantalla() { system("cls"); }
+// Función para limpiar la pantalla: con secuencias ANSI, sin lanzar un
+// proceso. Si la salida no es una terminal (o TERM=dumb) no escribe nada.
+void limpiarPantalla() {
+  const char *term = getenv("TERM");
+  if (!isatty(STDOUT_FILENO) || !term || strcmp(term, "dumb") == 0) return;
+  fputs("\033[H\033[2J", stdout);
+  fflush(stdout);
+}
 
 void presioneTeclaParaContinuar() {
-  puts("Presione una tecla para continuar...");
+  // Sin salto: queda como pregunta y la respuesta se lee en la misma línea
+  printf("Presione una tecla para continuar...");
+  fflush(stdout);
   getchar(); // Consume el '\n' del buffer de entrada
   getchar(); // Espera a que el usuario presione una tecla
 }
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "hashmap.h"
+#include "memoria.h"
+#include "traza.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPACIDAD_INICIAL 16
+
+struct HashMap {
+  MapPair **buckets;
+  long capacity;
+  long size;    // pares válidos
+  long used;    // pares válidos + casillas borradas
+  long current; // posición del recorrido
+  unsigned (*hash)(void *key);
+  int (*is_equal)(void *key1, void *key2);
+};
+
+typedef HashMap HashMap;
+
+// Marca de casilla borrada: mantiene la cadena de sondeo sin un par válido
+static MapPair borrado = {NULL, NULL};
+
+static void enlarge(HashMap *map, long nueva_capacidad) {
+  TRAZA_INICIO(inicio);
+  MapPair **viejos = map->buckets;
+  long vieja_capacidad = map->capacity;
+
+  map->buckets = (MapPair **)MEM_CALLOC(nueva_capacidad, sizeof(MapPair *), MEM_MAPA);
+  if (map->buckets == NULL) {
+    map->buckets = viejos; // Fallo en la asignación: se conserva la tabla
+    return;
+  }
+  map->capacity = nueva_capacidad;
+  map->used = map->size;
+
+  for (long i = 0; i < vieja_capacidad; i++) {
+    MapPair *pair = viejos[i];
+    if (pair == NULL || pair == &borrado) continue;
+    long pos = map->hash(pair->key) & (map->capacity - 1);
+    while (map->buckets[pos] != NULL)
+      pos = (pos + 1) & (map->capacity - 1);
+    map->buckets[pos] = pair;
+  }
+  MEM_FREE(viejos);
+  TRAZA_FIN(inicio, "hashmap_rehash", "tda");
+}
+
+HashMap *hashmap_create(unsigned (*hash)(void *key),
+                        int (*is_equal)(void *key1, void *key2)) {
+  HashMap *map = (HashMap *)MEM_MALLOC(sizeof(HashMap), MEM_MAPA);
+  if (map == NULL) return NULL;
+  map->buckets = (MapPair **)MEM_CALLOC(CAPACIDAD_INICIAL, sizeof(MapPair *), MEM_MAPA);
+  if (map->buckets == NULL) {
+    MEM_FREE(map);
+    return NULL;
+  }
+  map->capacity = CAPACIDAD_INICIAL;
+  map->size = 0;
+  map->used = 0;
+  map->current = -1;
+  map->hash = hash;
+  map->is_equal = is_equal;
+  return map;
+}
+
+// Devuelve la posición del par con la clave dada o -1 si no está
+static long buscar_posicion(HashMap *map, void *key) {
+  long pos = map->hash(key) & (map->capacity - 1);
+  while (map->buckets[pos] != NULL) {
+    MapPair *pair = map->buckets[pos];
+    if (pair != &borrado && map->is_equal(pair->key, key)) return pos;
+    pos = (pos + 1) & (map->capacity - 1);
+  }
+  return -1;
+}
+
+void hashmap_insert(HashMap *map, void *key, void *value) {
+  if (map == NULL || buscar_posicion(map, key) >= 0) return;
+
+  // Factor de carga máximo 0.7 (contando casillas borradas)
+  if ((map->used + 1) * 10 > map->capacity * 7) {
+    // Si la mayoría son borrados basta con reconstruir la tabla
+    long nueva = (map->size + 1) * 10 > map->capacity * 5 ? map->capacity * 2
+                                                          : map->capacity;
+    enlarge(map, nueva);
+  }
+
+  MapPair *pair = (MapPair *)MEM_MALLOC(sizeof(MapPair), MEM_PAR_MAPA);
+  if (pair == NULL) return;
+  pair->key = key;
+  pair->value = value;
+
+  long pos = map->hash(key) & (map->capacity - 1);
+  while (map->buckets[pos] != NULL && map->buckets[pos] != &borrado)
+    pos = (pos + 1) & (map->capacity - 1);
+  if (map->buckets[pos] == NULL) map->used++;
+  map->buckets[pos] = pair;
+  map->size++;
+}
+
+MapPair *hashmap_search(HashMap *map, void *key) {
+  if (map == NULL) return NULL;
+  long pos = buscar_posicion(map, key);
+  if (pos < 0) return NULL;
+  map->current = pos;
+  return map->buckets[pos];
+}
+
+MapPair *hashmap_remove(HashMap *map, void *key) {
+  if (map == NULL) return NULL;
+  long pos = buscar_posicion(map, key);
+  if (pos < 0) return NULL;
+  MapPair *pair = map->buckets[pos];
+  map->buckets[pos] = &borrado;
+  map->size--;
+  return pair;
+}
+
+MapPair *hashmap_first(HashMap *map) {
+  if (map == NULL) return NULL;
+  map->current = -1;
+  return hashmap_next(map);
+}
+
+MapPair *hashmap_next(HashMap *map) {
+  if (map == NULL) return NULL;
+  for (long i = map->current + 1; i < map->capacity; i++) {
+    if (map->buckets[i] != NULL && map->buckets[i] != &borrado) {
+      map->current = i;
+      return map->buckets[i];
+    }
+  }
+  map->current = map->capacity;
+  return NULL;
+}
+
+int hashmap_size(HashMap *map) { return map ? (int)map->size : 0; }
+
+void hashmap_clean(HashMap *map) {
+  if (map == NULL) return;
+  for (long i = 0; i < map->capacity; i++) {
+    if (map->buckets[i] != NULL && map->buckets[i] != &borrado)
+      MEM_FREE(map->buckets[i]);
+    map->buckets[i] = NULL;
+  }
+  map->size = 0;
+  map->used = 0;
+  map->current = -1;
+}
+
+void hashmap_destroy(HashMap *map) {
+  if (map == NULL) return;
+  hashmap_clean(map);
+  MEM_FREE(map->buckets);
+  MEM_FREE(map);
+}
+
+unsigned hash_int(void *key) {
+  // Mezcla de bits (finalizador de murmur3) para no agrupar IDs consecutivos
+  unsigned h = (unsigned)*(int *)key;
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+unsigned hash_string(void *key) {
+  // FNV-1a
+  unsigned h = 2166136261u;
+  for (const unsigned char *c = key; *c; c++) {
+    h ^= *c;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+int is_equal_int(void *key1, void *key2) {
+  return *(int *)key1 == *(int *)key2;
+}
+
+int is_equal_string(void *key1, void *key2) {
+  return strcmp((char *)key1, (char *)key2) == 0;
+}
@@ -0,0 +1,47 @@
+#ifndef HASHMAP_H
+#define HASHMAP_H
+#include "map.h"
+
+// Mapa hash con direccionamiento abierto (sondeo lineal). A diferencia de
+// Map, la búsqueda, inserción y eliminación son O(1) en promedio. Las claves
+// son punteros (por lo general a un campo del propio valor), igual que en Map.
+
+typedef struct HashMap HashMap;
+
+// Crea un mapa vacío que usa la función hash y la función de igualdad dadas.
+HashMap *hashmap_create(unsigned (*hash)(void *key),
+                        int (*is_equal)(void *key1, void *key2));
+
+// Inserta el par (key, value). Si la clave ya existe no hace nada.
+void hashmap_insert(HashMap *map, void *key, void *value);
+
+// Devuelve el par asociado a la clave o NULL si no existe.
+MapPair *hashmap_search(HashMap *map, void *key);
+
+// Elimina el par asociado a la clave y lo devuelve (el llamador debe liberarlo
+// con MEM_FREE).
+MapPair *hashmap_remove(HashMap *map, void *key);
+
+// Recorrido de los pares (el orden no está definido).
+MapPair *hashmap_first(HashMap *map);
+
+MapPair *hashmap_next(HashMap *map);
+
+int hashmap_size(HashMap *map);
+
+// Elimina todos los pares del mapa.
+void hashmap_clean(HashMap *map);
+
+// Libera el mapa con sus pares (no las claves ni los valores).
+void hashmap_destroy(HashMap *map);
+
+// Funciones hash e igualdad para claves int* y char*.
+unsigned hash_int(void *key);
+
+unsigned hash_string(void *key);
+
+int is_equal_int(void *key1, void *key2);
+
+int is_equal_string(void *key1, void *key2);
+
+#endif /* HASHMAP_H */
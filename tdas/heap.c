@@ -4,6 +4,7 @@
 #include <math.h>
 #include <ctype.h>
 #include "heap.h"
+#include "memoria.h"
 
 typedef struct nodo{
    void* data;
@@ -28,7 +29,7 @@ void heap_push(Heap* pq, void* data, int priority){
         //printf("se expande de %i a ", pq->capac);
         pq->capac=(pq->capac)*2+1;
         //printf("%i * %lu", pq->capac, sizeof(heapElem));
-        pq->heapArray=realloc(pq->heapArray, (pq->capac)*sizeof(heapElem));
+        pq->heapArray=MEM_REALLOC(pq->heapArray, (pq->capac)*sizeof(heapElem), MEM_HEAP);
     }
 
     /*FlotaciÃ³n*/
@@ -45,6 +46,7 @@ void heap_push(Heap* pq, void* data, int priority){
 
 
 void heap_pop(Heap* pq){
+        if(pq->size==0) return;
 
         pq->size--;
         pq->heapArray[0] = pq->heapArray[pq->size];
@@ -66,9 +68,19 @@ void heap_pop(Heap* pq){
 }
 
 Heap* heap_create(){
-   Heap *pq=(Heap*) malloc(sizeof(Heap));
-   pq->heapArray=(heapElem*) malloc(3*sizeof(heapElem));
+   Heap *pq=(Heap*) MEM_MALLOC(sizeof(Heap), MEM_HEAP);
+   pq->heapArray=(heapElem*) MEM_MALLOC(3*sizeof(heapElem), MEM_HEAP);
    pq->size=0;
    pq->capac=3; //capacidad inicial
    return pq;
 }
+
+int heap_size(Heap* pq){
+   return pq->size;
+}
+
+void heap_destroy(Heap* pq){
+   if(pq==NULL) return;
+   MEM_FREE(pq->heapArray);
+   MEM_FREE(pq);
+}
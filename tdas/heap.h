@@ -11,4 +11,9 @@ void heap_pop(Heap* pq);
 
 Heap* heap_create();
 
+int heap_size(Heap* pq);
+
+// Libera el heap (no los datos que contiene)
+void heap_destroy(Heap* pq);
+
 #endif
\ No newline at end of file
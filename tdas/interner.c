@@ -0,0 +1,73 @@
+#include "interner.h"
+#include "hashmap.h"
+#include "memoria.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Cada cadena se guarda junto a su símbolo en una sola asignación
+typedef struct {
+  Simbolo id;
+  char texto[];
+} Entrada;
+
+struct Interner {
+  HashMap *por_texto; // texto -> Entrada*
+  Entrada **entradas; // símbolo -> Entrada*
+  int size;
+  int capac;
+};
+
+typedef Interner Interner;
+
+Interner *interner_create() {
+  Interner *I = (Interner *)MEM_MALLOC(sizeof(Interner), MEM_CADENA);
+  if (I == NULL) return NULL;
+  I->por_texto = hashmap_create(hash_string, is_equal_string);
+  I->capac = 16;
+  I->entradas = (Entrada **)MEM_MALLOC(I->capac * sizeof(Entrada *), MEM_CADENA);
+  I->size = 0;
+  if (I->por_texto == NULL || I->entradas == NULL) {
+    MEM_FREE(I->entradas);
+    MEM_FREE(I);
+    return NULL;
+  }
+  interner_intern(I, ""); // símbolo 0
+  return I;
+}
+
+Simbolo interner_intern(Interner *I, const char *texto) {
+  if (I == NULL || texto == NULL) return 0;
+  MapPair *pair = hashmap_search(I->por_texto, (void *)texto);
+  if (pair != NULL) return ((Entrada *)pair->value)->id;
+
+  if (I->size == I->capac) {
+    Entrada **nuevas =
+        (Entrada **)MEM_REALLOC(I->entradas, I->capac * 2 * sizeof(Entrada *),
+                                MEM_CADENA);
+    if (nuevas == NULL) return 0;
+    I->entradas = nuevas;
+    I->capac *= 2;
+  }
+  size_t largo = strlen(texto);
+  Entrada *e = (Entrada *)MEM_MALLOC(sizeof(Entrada) + largo + 1, MEM_CADENA);
+  if (e == NULL) return 0;
+  e->id = (Simbolo)I->size;
+  memcpy(e->texto, texto, largo + 1);
+  I->entradas[I->size++] = e;
+  hashmap_insert(I->por_texto, e->texto, e);
+  return e->id;
+}
+
+Simbolo interner_lookup(Interner *I, const char *texto) {
+  if (I == NULL || texto == NULL) return 0;
+  MapPair *pair = hashmap_search(I->por_texto, (void *)texto);
+  return pair ? ((Entrada *)pair->value)->id : 0;
+}
+
+const char *interner_text(Interner *I, Simbolo s) {
+  if (I == NULL || s >= (Simbolo)I->size) return "";
+  return I->entradas[s]->texto;
+}
+
+int interner_size(Interner *I) { return I ? I->size : 0; }
@@ -0,0 +1,28 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+// Tabla de cadenas internadas: cada cadena distinta se guarda una sola vez y
+// se identifica por un símbolo de 32 bits. Dos cadenas son iguales si y sólo
+// si sus símbolos son iguales. El símbolo 0 es siempre la cadena vacía.
+
+typedef unsigned int Simbolo;
+
+typedef struct Interner Interner;
+
+// Esta función crea una tabla que sólo contiene la cadena vacía.
+Interner *interner_create();
+
+// Esta función devuelve el símbolo de la cadena, agregándola si no existía.
+Simbolo interner_intern(Interner *I, const char *texto);
+
+// Esta función devuelve el símbolo de la cadena o 0 si no fue internada
+// (sin agregarla).
+Simbolo interner_lookup(Interner *I, const char *texto);
+
+// Esta función devuelve la cadena del símbolo ("" si no existe).
+const char *interner_text(Interner *I, Simbolo s);
+
+// Esta función devuelve la cantidad de cadenas distintas.
+int interner_size(Interner *I);
+
+#endif /* INTERNER_H */
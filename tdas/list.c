@@ -1,4 +1,5 @@
 #include "list.h"
+#include "memoria.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -17,7 +18,7 @@ struct List {
 typedef List List;
 
 List *list_create() {
-  List *newList = (List *)malloc(sizeof(List));
+  List *newList = (List *)MEM_MALLOC(sizeof(List), MEM_LISTA);
   if (newList == NULL) {
     return NULL; // Fallo en la asignación de memoria
   }
@@ -48,7 +49,7 @@ void list_pushFront(List *L, void *data) {
   if (L == NULL) {
     return; // Lista no inicializada
   }
-  Node *newNode = (Node *)malloc(sizeof(Node));
+  Node *newNode = (Node *)MEM_MALLOC(sizeof(Node), MEM_NODO_LISTA);
   if (newNode == NULL) {
     return; // Fallo en la asignación de memoria
   }
@@ -65,7 +66,7 @@ void list_pushBack(List *L, void *data) {
   if (L == NULL) {
     return; // Lista no inicializada
   }
-  Node *newNode = (Node *)malloc(sizeof(Node));
+  Node *newNode = (Node *)MEM_MALLOC(sizeof(Node), MEM_NODO_LISTA);
   if (newNode == NULL) {
     return; // Fallo en la asignación de memoria
   }
@@ -85,7 +86,7 @@ void list_pushCurrent(List *L, void *data) {
   if (L == NULL || L->current == NULL) {
     return; // Lista no inicializada o current no está definido
   }
-  Node *newNode = (Node *)malloc(sizeof(Node));
+  Node *newNode = (Node *)MEM_MALLOC(sizeof(Node), MEM_NODO_LISTA);
   if (newNode == NULL) {
     return; // Fallo en la asignación de memoria
   }
@@ -133,7 +134,7 @@ void *list_popFront(List *L) {
     L->tail = NULL; // La lista ahora está vacía
   }
   void *data = temp->data;
-  free(temp);
+  MEM_FREE(temp);
   L->size--;
   return data;
 }
@@ -150,7 +151,7 @@ void *list_popBack(List *L) {
     current = current->next;
   }
   void *data = L->tail->data;
-  free(L->tail);
+  MEM_FREE(L->tail);
   current->next = NULL;
   L->tail = current;
   L->size--;
@@ -178,7 +179,7 @@ void *list_popCurrent(List *L) {
     L->tail = temp; // Actualizar tail si se elimina el último elemento
   }
   void *data = L->current->data;
-  free(L->current);
+  MEM_FREE(L->current);
   L->current = temp->next;
   L->size--;
   return data;
@@ -192,7 +193,7 @@ void list_clean(List *L) {
   Node *next;
   while (current != NULL) {
     next = current->next;
-    free(current);
+    MEM_FREE(current);
     current = next;
   }
   L->head = NULL;
@@ -1,5 +1,6 @@
 #include "map.h"
 #include "list.h"
+#include "memoria.h"
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -19,7 +20,7 @@ int pair_lt(void *pair1, void *pair2) {
 }
 
 Map *sorted_map_create(int (*lower_than)(void *key1, void *key2)) {
-  Map *newMap = (Map *)malloc(sizeof(Map));
+  Map *newMap = (Map *)MEM_MALLOC(sizeof(Map), MEM_MAPA);
   newMap->lower_than = lower_than;
   newMap->is_equal = NULL;
   newMap->ls = list_create();
@@ -28,7 +29,7 @@ Map *sorted_map_create(int (*lower_than)(void *key1, void *key2)) {
 }
 
 Map *map_create(int (*is_equal)(void *key1, void *key2)) {
-  Map *newMap = (Map *)malloc(sizeof(Map));
+  Map *newMap = (Map *)MEM_MALLOC(sizeof(Map), MEM_MAPA);
   newMap->lower_than = NULL;
   newMap->is_equal = is_equal;
   newMap->ls = list_create();
@@ -38,7 +39,7 @@ Map *map_create(int (*is_equal)(void *key1, void *key2)) {
 
 
 void multimap_insert(Map *map, void *key, void *value) {
-  MapPair *pair = (MapPair *)malloc(sizeof(MapPair));
+  MapPair *pair = (MapPair *)MEM_MALLOC(sizeof(MapPair), MEM_PAR_MAPA);
   pair->key = key;
   pair->value = value;
 
@@ -0,0 +1,133 @@
+#include "memoria.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Cabecera delante de cada bloque instrumentado; la unión mantiene la
+// alineación que garantiza malloc para lo que viene después.
+typedef union {
+  struct {
+    size_t tam;
+    EtiquetaMemoria etiqueta;
+  } info;
+  long double alineacion;
+} Cabecera;
+
+// Los contadores se actualizan con operaciones atómicas relajadas, sin orden
+// entre ellos, para que se pueda asignar desde más de un hilo
+typedef struct {
+  _Atomic long asignaciones; // bloques pedidos en total
+  _Atomic long vivos;        // bloques sin liberar
+  _Atomic size_t bytes;      // bytes vivos
+  _Atomic size_t pico;       // máximo de bytes vivos
+} ContadorMemoria;
+
+static ContadorMemoria contadores[MEM_NUM_ETIQUETAS];
+static _Atomic size_t bytes_vivos = 0; // todas las etiquetas
+static _Atomic size_t pico_total = 0;
+
+static const char *nombres[MEM_NUM_ETIQUETAS] = {
+    "otro",    "lista",   "nodo lista", "mapa",     "par mapa",
+    "heap",    "sala",    "paciente",   "insumo",   "lote",
+    "stock",   "indice",  "temporal",   "trie",     "arraylist",
+    "cadena",  "vista",    "texto"};
+
+#define RELAJADO memory_order_relaxed
+
+static void subir_pico(_Atomic size_t *pico, size_t valor) {
+  size_t actual = atomic_load_explicit(pico, RELAJADO);
+  while (valor > actual &&
+         !atomic_compare_exchange_weak_explicit(pico, &actual, valor, RELAJADO,
+                                                RELAJADO))
+    ;
+}
+
+static void sumar(EtiquetaMemoria etiqueta, size_t tam) {
+  ContadorMemoria *c = &contadores[etiqueta];
+  atomic_fetch_add_explicit(&c->asignaciones, 1, RELAJADO);
+  atomic_fetch_add_explicit(&c->vivos, 1, RELAJADO);
+  subir_pico(&c->pico, atomic_fetch_add_explicit(&c->bytes, tam, RELAJADO) + tam);
+  subir_pico(&pico_total,
+             atomic_fetch_add_explicit(&bytes_vivos, tam, RELAJADO) + tam);
+}
+
+static void restar(EtiquetaMemoria etiqueta, size_t tam) {
+  ContadorMemoria *c = &contadores[etiqueta];
+  atomic_fetch_sub_explicit(&c->vivos, 1, RELAJADO);
+  atomic_fetch_sub_explicit(&c->bytes, tam, RELAJADO);
+  atomic_fetch_sub_explicit(&bytes_vivos, tam, RELAJADO);
+}
+
+void *mem_malloc(size_t tam, EtiquetaMemoria etiqueta) {
+  if ((int)etiqueta < 0 || etiqueta >= MEM_NUM_ETIQUETAS) etiqueta = MEM_OTRO;
+  Cabecera *c = (Cabecera *)malloc(sizeof(Cabecera) + tam);
+  if (c == NULL) return NULL;
+  c->info.tam = tam;
+  c->info.etiqueta = etiqueta;
+  sumar(etiqueta, tam);
+  return c + 1;
+}
+
+void *mem_calloc(size_t n, size_t tam, EtiquetaMemoria etiqueta) {
+  if (tam != 0 && n > ((size_t)-1 - sizeof(Cabecera)) / tam) return NULL;
+  void *ptr = mem_malloc(n * tam, etiqueta);
+  if (ptr != NULL) memset(ptr, 0, n * tam);
+  return ptr;
+}
+
+void *mem_realloc(void *ptr, size_t tam, EtiquetaMemoria etiqueta) {
+  if (ptr == NULL) return mem_malloc(tam, etiqueta);
+  Cabecera *c = (Cabecera *)ptr - 1;
+  size_t anterior = c->info.tam;
+  EtiquetaMemoria propia = c->info.etiqueta;
+  Cabecera *nuevo = (Cabecera *)realloc(c, sizeof(Cabecera) + tam);
+  if (nuevo == NULL) return NULL;
+  // Cuenta como una liberación y una asignación del mismo tipo
+  restar(propia, anterior);
+  sumar(propia, tam);
+  nuevo->info.tam = tam;
+  return nuevo + 1;
+}
+
+void mem_free(void *ptr) {
+  if (ptr == NULL) return;
+  Cabecera *c = (Cabecera *)ptr - 1;
+  restar(c->info.etiqueta, c->info.tam);
+  free(c);
+}
+
+int mem_activa() {
+#ifdef MEMORIA_INSTRUMENTADA
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+void mem_report(FILE *salida, const char *titulo) {
+  if (!mem_activa()) return;
+
+  // Si otros hilos asignan a la vez, cada fila es una foto aproximada
+  long total_asignaciones = 0, total_vivos = 0;
+  size_t total_bytes = 0;
+  fprintf(salida, "\n--- Memoria: %s ---\n", titulo);
+  fprintf(salida, "%-12s %12s %10s %12s %12s\n", "tipo", "asignaciones",
+          "vivos", "bytes vivos", "pico bytes");
+  for (int i = 0; i < MEM_NUM_ETIQUETAS; i++) {
+    ContadorMemoria *c = &contadores[i];
+    long asignaciones = atomic_load_explicit(&c->asignaciones, RELAJADO);
+    if (asignaciones == 0) continue;
+    long vivos = atomic_load_explicit(&c->vivos, RELAJADO);
+    size_t bytes = atomic_load_explicit(&c->bytes, RELAJADO);
+    fprintf(salida, "%-12s %12ld %10ld %12zu %12zu\n", nombres[i],
+            asignaciones, vivos, bytes, atomic_load_explicit(&c->pico, RELAJADO));
+    total_asignaciones += asignaciones;
+    total_vivos += vivos;
+    total_bytes += bytes;
+  }
+  // El pico conjunto, no la suma de los picos
+  fprintf(salida, "%-12s %12ld %10ld %12zu %12zu\n", "total",
+          total_asignaciones, total_vivos, total_bytes,
+          atomic_load_explicit(&pico_total, RELAJADO));
+}
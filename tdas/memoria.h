@@ -0,0 +1,72 @@
+#ifndef MEMORIA_H
+#define MEMORIA_H
+#include <stddef.h>
+#include <stdio.h>
+
+// Capa opcional de asignación instrumentada. Compilando con
+// -DMEMORIA_INSTRUMENTADA cada bloque lleva una etiqueta con el tipo de dato
+// y se cuentan, por etiqueta, asignaciones, bloques y bytes vivos y el pico de
+// bytes. Sin esa opción las macros son malloc, calloc, realloc y free. Los
+// contadores son atómicos: se puede asignar desde cualquier hilo.
+//
+// Un bloque pedido con MEM_MALLOC, MEM_CALLOC o MEM_REALLOC se libera siempre
+// con MEM_FREE (y nunca con free directamente).
+
+typedef enum {
+  MEM_OTRO,
+  MEM_LISTA,       // List
+  MEM_NODO_LISTA,  // nodos de List
+  MEM_MAPA,        // Map y HashMap (incluidas sus tablas)
+  MEM_PAR_MAPA,    // MapPair
+  MEM_HEAP,        // Heap y su arreglo
+  MEM_SALA,        // tabla de salas y arreglos de cada sala
+  MEM_PACIENTE,    // almacén de pacientes
+  MEM_INSUMO,      // catálogo de insumos
+  MEM_LOTE,        // lotes de insumos
+  MEM_STOCK,       // StockDiario y filas leídas de insumos.csv
+  MEM_INDICE,      // grupos de los índices de pacientes
+  MEM_TEMPORAL,    // arreglos de trabajo de una operación
+  MEM_TRIE,        // nodos del trie
+  MEM_ARREGLO,     // ArrayList y su arreglo
+  MEM_CADENA,      // cadenas internadas
+  MEM_VISTA,       // vistas del estado publicadas para otros hilos
+  MEM_TEXTO,       // buffers de Texto y líneas de la Pantalla
+  MEM_NUM_ETIQUETAS
+} EtiquetaMemoria;
+
+#ifdef MEMORIA_INSTRUMENTADA
+#define MEM_MALLOC(tam, etiqueta) mem_malloc((tam), (etiqueta))
+#define MEM_CALLOC(n, tam, etiqueta) mem_calloc((n), (tam), (etiqueta))
+#define MEM_REALLOC(ptr, tam, etiqueta) mem_realloc((ptr), (tam), (etiqueta))
+#define MEM_FREE(ptr) mem_free(ptr)
+#else
+#include <stdlib.h>
+// La etiqueta se evalúa igual, para que no quede sin usar
+#define MEM_MALLOC(tam, etiqueta) ((void)(etiqueta), malloc(tam))
+#define MEM_CALLOC(n, tam, etiqueta) ((void)(etiqueta), calloc((n), (tam)))
+#define MEM_REALLOC(ptr, tam, etiqueta) ((void)(etiqueta), realloc((ptr), (tam)))
+#define MEM_FREE(ptr) free(ptr)
+#endif
+
+// Esta función asigna tam bytes con la etiqueta dada.
+void *mem_malloc(size_t tam, EtiquetaMemoria etiqueta);
+
+// Esta función asigna n * tam bytes en cero con la etiqueta dada.
+void *mem_calloc(size_t n, size_t tam, EtiquetaMemoria etiqueta);
+
+// Esta función cambia el tamaño del bloque; si ptr es NULL lo crea con la
+// etiqueta dada, si no conserva la que ya tenía.
+void *mem_realloc(void *ptr, size_t tam, EtiquetaMemoria etiqueta);
+
+// Esta función libera un bloque pedido con las funciones anteriores.
+void mem_free(void *ptr);
+
+// Esta función devuelve 1 si el programa se compiló con la instrumentación.
+int mem_activa();
+
+// Esta función escribe en salida una tabla por etiqueta con asignaciones
+// totales, bloques y bytes vivos y el pico de bytes. No escribe nada si la
+// instrumentación está desactivada.
+void mem_report(FILE *salida, const char *titulo);
+
+#endif /* MEMORIA_H */
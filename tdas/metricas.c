@@ -0,0 +1,195 @@
+#include "metricas.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_CONTADORES 32
+#define MAX_HISTOGRAMAS 16
+#define MAX_NOMBRE 64
+#define MAX_AYUDA 128
+
+#define BITS_SUB 4                 // 16 casillas por potencia de 2
+#define SUB (1 << BITS_SUB)
+#define NUM_CASILLAS ((64 - BITS_SUB + 1) * SUB) // hasta 2^64 - 1
+
+struct Contador {
+  char nombre[MAX_NOMBRE];
+  char ayuda[MAX_AYUDA];
+  int es_indicador;
+  long valor;
+};
+
+struct Histograma {
+  char nombre[MAX_NOMBRE];
+  char ayuda[MAX_AYUDA];
+  long cantidad;
+  uint64_t suma;                   // nanosegundos
+  uint64_t minimo, maximo;
+  long casillas[NUM_CASILLAS];
+};
+
+static Contador contadores[MAX_CONTADORES];
+static int num_contadores = 0;
+static Histograma histogramas[MAX_HISTOGRAMAS];
+static int num_histogramas = 0;
+
+// Límites (en segundos) de los buckets que se exportan
+static const double LIMITES[] = {1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1, 10};
+static const int NUM_LIMITES = sizeof(LIMITES) / sizeof(LIMITES[0]);
+static const double CUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+static const int NUM_CUANTILES = sizeof(CUANTILES) / sizeof(CUANTILES[0]);
+
+uint64_t metricas_ahora_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void copiar(char *destino, const char *origen, size_t tam) {
+  strncpy(destino, origen ? origen : "", tam - 1);
+  destino[tam - 1] = '\0';
+}
+
+static Contador *registrar_contador(const char *nombre, const char *ayuda,
+                                    int es_indicador) {
+  for (int i = 0; i < num_contadores; i++)
+    if (strcmp(contadores[i].nombre, nombre) == 0) return &contadores[i];
+  if (num_contadores == MAX_CONTADORES) return NULL;
+  Contador *c = &contadores[num_contadores++];
+  copiar(c->nombre, nombre, sizeof(c->nombre));
+  copiar(c->ayuda, ayuda, sizeof(c->ayuda));
+  c->es_indicador = es_indicador;
+  c->valor = 0;
+  return c;
+}
+
+Contador *metricas_contador(const char *nombre, const char *ayuda) {
+  return registrar_contador(nombre, ayuda, 0);
+}
+
+Contador *metricas_indicador(const char *nombre, const char *ayuda) {
+  return registrar_contador(nombre, ayuda, 1);
+}
+
+void contador_sumar(Contador *c, long n) {
+  if (c) c->valor += n;
+}
+
+void indicador_fijar(Contador *c, long valor) {
+  if (c) c->valor = valor;
+}
+
+long contador_valor(Contador *c) { return c ? c->valor : 0; }
+
+Histograma *metricas_histograma(const char *nombre, const char *ayuda) {
+  for (int i = 0; i < num_histogramas; i++)
+    if (strcmp(histogramas[i].nombre, nombre) == 0) return &histogramas[i];
+  if (num_histogramas == MAX_HISTOGRAMAS) return NULL;
+  Histograma *h = &histogramas[num_histogramas++];
+  memset(h, 0, sizeof(Histograma));
+  copiar(h->nombre, nombre, sizeof(h->nombre));
+  copiar(h->ayuda, ayuda, sizeof(h->ayuda));
+  return h;
+}
+
+// Los valores menores que SUB tienen casilla propia; el resto se agrupa por
+// potencia de 2 (exponente) y por los BITS_SUB bits que siguen al primero
+static int casilla(uint64_t v) {
+  if (v < SUB) return (int)v;
+#ifdef __GNUC__
+  int e = 63 - __builtin_clzll(v);
+#else
+  int e = 0;
+  for (uint64_t x = v; x > 1; x >>= 1) e++;
+#endif
+  int sub = (int)((v >> (e - BITS_SUB)) & (SUB - 1));
+  return (e - BITS_SUB + 1) * SUB + sub;
+}
+
+// Menor valor que cae en la casilla i
+static uint64_t inicio_casilla(int i) {
+  if (i < SUB) return (uint64_t)i;
+  int e = i / SUB + BITS_SUB - 1;
+  return (uint64_t)(SUB + i % SUB) << (e - BITS_SUB);
+}
+
+static uint64_t fin_casilla(int i) { // excluido
+  return i + 1 < NUM_CASILLAS ? inicio_casilla(i + 1) : UINT64_MAX;
+}
+
+void histograma_registrar(Histograma *h, uint64_t ns) {
+  if (!h) return;
+  if (h->cantidad == 0 || ns < h->minimo) h->minimo = ns;
+  if (ns > h->maximo) h->maximo = ns;
+  h->cantidad++;
+  h->suma += ns;
+  h->casillas[casilla(ns)]++;
+}
+
+void histograma_desde(Histograma *h, uint64_t inicio) {
+  if (h) histograma_registrar(h, metricas_ahora_ns() - inicio);
+}
+
+long histograma_cantidad(Histograma *h) { return h ? h->cantidad : 0; }
+
+uint64_t histograma_cuantil(Histograma *h, double q) {
+  if (!h || h->cantidad == 0) return 0;
+  long objetivo = (long)(q * h->cantidad + 0.5);
+  if (objetivo < 1) objetivo = 1;
+  long acumulado = 0;
+  for (int i = 0; i < NUM_CASILLAS; i++) {
+    acumulado += h->casillas[i];
+    if (acumulado >= objetivo) {
+      uint64_t medio = inicio_casilla(i) + (fin_casilla(i) - inicio_casilla(i)) / 2;
+      if (medio < h->minimo) medio = h->minimo;
+      if (medio > h->maximo) medio = h->maximo;
+      return medio;
+    }
+  }
+  return h->maximo;
+}
+
+static void escribir_histograma(FILE *f, Histograma *h) {
+  fprintf(f, "# HELP %s %s\n# TYPE %s histogram\n", h->nombre, h->ayuda,
+          h->nombre);
+  // Cada casilla cuenta en el primer límite que contiene todo su rango
+  long acumulado = 0;
+  int i = 0;
+  for (int l = 0; l < NUM_LIMITES; l++) {
+    uint64_t limite_ns = (uint64_t)(LIMITES[l] * 1e9);
+    while (i < NUM_CASILLAS && fin_casilla(i) - 1 <= limite_ns)
+      acumulado += h->casillas[i++];
+    fprintf(f, "%s_bucket{le=\"%g\"} %ld\n", h->nombre, LIMITES[l], acumulado);
+  }
+  fprintf(f, "%s_bucket{le=\"+Inf\"} %ld\n", h->nombre, h->cantidad);
+  fprintf(f, "%s_sum %.9f\n", h->nombre, h->suma / 1e9);
+  fprintf(f, "%s_count %ld\n", h->nombre, h->cantidad);
+
+  fprintf(f, "# HELP %s_quantile Cuantiles de %s (segundos)\n", h->nombre,
+          h->nombre);
+  fprintf(f, "# TYPE %s_quantile gauge\n", h->nombre);
+  for (int k = 0; k < NUM_CUANTILES; k++)
+    fprintf(f, "%s_quantile{quantile=\"%g\"} %.9f\n", h->nombre, CUANTILES[k],
+            histograma_cuantil(h, CUANTILES[k]) / 1e9);
+}
+
+int metricas_exportar(const char *ruta) {
+  char temporal[512];
+  snprintf(temporal, sizeof(temporal), "%s.tmp", ruta);
+  FILE *f = fopen(temporal, "w");
+  if (!f) return 0;
+
+  for (int i = 0; i < num_contadores; i++) {
+    Contador *c = &contadores[i];
+    fprintf(f, "# HELP %s %s\n# TYPE %s %s\n%s %ld\n", c->nombre, c->ayuda,
+            c->nombre, c->es_indicador ? "gauge" : "counter", c->nombre,
+            c->valor);
+  }
+  for (int i = 0; i < num_histogramas; i++) escribir_histograma(f, &histogramas[i]);
+
+  if (fclose(f) != 0) {
+    remove(temporal);
+    return 0;
+  }
+  return rename(temporal, ruta) == 0;
+}
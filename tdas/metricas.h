@@ -0,0 +1,52 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+#include <stdint.h>
+
+// Métricas livianas del programa: contadores, indicadores y histogramas de
+// latencia. Los histogramas son log-lineales (al estilo HDR): 16 casillas por
+// cada potencia de 2, así que registrar un valor es O(1) y el error relativo
+// de los cuantiles es de a lo más ~6%. Todas las funciones aceptan NULL y en
+// ese caso no hacen nada, de modo que una métrica no registrada no cuesta.
+
+typedef struct Contador Contador;
+typedef struct Histograma Histograma;
+
+// Esta función devuelve el reloj monotónico en nanosegundos.
+uint64_t metricas_ahora_ns();
+
+// Esta función registra (o devuelve, si ya existe) un contador que sólo
+// crece. NULL si no quedan espacios.
+Contador *metricas_contador(const char *nombre, const char *ayuda);
+
+// Esta función registra (o devuelve) un indicador: un valor que se fija.
+Contador *metricas_indicador(const char *nombre, const char *ayuda);
+
+void contador_sumar(Contador *c, long n);
+
+void indicador_fijar(Contador *c, long valor);
+
+long contador_valor(Contador *c);
+
+// Esta función registra (o devuelve) un histograma de duraciones en
+// nanosegundos; se exporta en segundos.
+Histograma *metricas_histograma(const char *nombre, const char *ayuda);
+
+// Esta función suma una observación de ns nanosegundos.
+void histograma_registrar(Histograma *h, uint64_t ns);
+
+// Esta función registra el tiempo transcurrido desde inicio (de
+// metricas_ahora_ns).
+void histograma_desde(Histograma *h, uint64_t inicio);
+
+long histograma_cantidad(Histograma *h);
+
+// Esta función devuelve el cuantil q (0..1) en nanosegundos, aproximado por
+// el punto medio de su casilla (0 si no hay observaciones).
+uint64_t histograma_cuantil(Histograma *h, double q);
+
+// Esta función escribe todas las métricas en formato de texto de Prometheus.
+// Escribe primero un archivo temporal y lo renombra, así quien lo lea nunca
+// ve un archivo a medias. Devuelve 0 si no pudo escribirlo.
+int metricas_exportar(const char *ruta);
+
+#endif /* METRICAS_H */
@@ -0,0 +1,245 @@
+#define _GNU_SOURCE
+#include "pantalla.h"
+#include "memoria.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+
+// Una línea lógica del cuadro: empieza en fila y ocupa alto filas (las
+// largas se parten en la terminal)
+typedef struct {
+  char *texto;
+  size_t largo;
+  int fila;
+  int alto;
+  int sucia; // en pantalla hay algo más (el eco de la entrada)
+} Linea;
+
+typedef struct {
+  Linea *lineas;
+  int cantidad;
+  int capacidad;
+} Cuadro;
+
+struct Pantalla {
+  FILE *destino;
+  FILE *flujo;
+  int fd;
+  int filas, columnas;
+  Cuadro anterior;      // lo que hay en pantalla del cuadro anterior
+  Cuadro actual;
+  int siguiente;        // anterior.lineas[siguiente] es la primera que falta comparar
+  int fila;             // fila donde va la próxima línea
+  int de_corrido;       // se escribe sin comparar (no cabe o aún no hay cuadro)
+  char *parcial;        // línea en curso, todavía sin su salto
+  size_t largo_parcial, capacidad_parcial;
+  long escritas, omitidas;
+};
+
+static void vaciar_cuadro(Cuadro *c) {
+  for (int i = 0; i < c->cantidad; i++) MEM_FREE(c->lineas[i].texto);
+  c->cantidad = 0;
+}
+
+static void agregar_linea(Cuadro *c, const char *texto, size_t largo, int fila,
+                          int alto, int sucia) {
+  if (c->cantidad == c->capacidad) {
+    int nueva = c->capacidad ? c->capacidad * 2 : 64;
+    Linea *lineas = (Linea *)MEM_REALLOC(c->lineas, nueva * sizeof(Linea), MEM_TEXTO);
+    if (lineas == NULL) return;
+    c->lineas = lineas;
+    c->capacidad = nueva;
+  }
+  char *copia = (char *)MEM_MALLOC(largo + 1, MEM_TEXTO);
+  if (copia == NULL) return;
+  memcpy(copia, texto, largo);
+  copia[largo] = '\0';
+  c->lineas[c->cantidad++] = (Linea){copia, largo, fila, alto, sucia};
+}
+
+static void medir_terminal(Pantalla *p) {
+  struct winsize w;
+  if (ioctl(p->fd, TIOCGWINSZ, &w) == 0 && w.ws_row > 0 && w.ws_col > 0) {
+    p->filas = w.ws_row;
+    p->columnas = w.ws_col;
+  } else {
+    p->filas = 24;
+    p->columnas = 80;
+  }
+}
+
+// Columnas que ocupa el texto: se cuentan caracteres, no bytes de UTF-8
+static int ancho_linea(const char *texto, size_t largo) {
+  int ancho = 0;
+  for (size_t i = 0; i < largo; i++)
+    if (((unsigned char)texto[i] & 0xC0) != 0x80) ancho++;
+  return ancho;
+}
+
+static void mover(Pantalla *p, int fila) {
+  fprintf(p->destino, "\033[%d;1H", fila + 1);
+}
+
+// Si la línea que empezaba en esta fila del cuadro anterior es igual, no hace
+// falta escribirla
+static int sin_cambios(Pantalla *p, const char *texto, size_t largo) {
+  Cuadro *a = &p->anterior;
+  while (p->siguiente < a->cantidad && a->lineas[p->siguiente].fila < p->fila)
+    p->siguiente++;
+  if (p->siguiente >= a->cantidad) return 0;
+  Linea *l = &a->lineas[p->siguiente];
+  return l->fila == p->fila && !l->sucia && l->largo == largo &&
+         memcmp(l->texto, texto, largo) == 0;
+}
+
+// Escribe una línea completa (pregunta = 0) o una pregunta sin su salto
+static void escribir_linea(Pantalla *p, const char *texto, size_t largo,
+                           int pregunta) {
+  int ancho = ancho_linea(texto, largo);
+  int alto = ancho == 0 ? 1 : (ancho + p->columnas - 1) / p->columnas;
+  if (!p->de_corrido && p->fila + alto >= p->filas) {
+    // No cabe: desde acá se escribe de corrido y la terminal se desplaza
+    mover(p, p->fila);
+    fputs("\033[J", p->destino);
+    p->de_corrido = 1;
+  }
+  if (p->de_corrido) {
+    fwrite(texto, 1, largo, p->destino);
+    if (!pregunta) fputc('\n', p->destino);
+    p->escritas++;
+    return;
+  }
+
+  if (!pregunta && sin_cambios(p, texto, largo)) {
+    p->omitidas++;
+  } else {
+    mover(p, p->fila);
+    fwrite(texto, 1, largo, p->destino);
+    // Con la última columna ocupada el cursor espera para pasar de fila y
+    // \033[K borraría ese último caracter
+    if (ancho % p->columnas != 0 || ancho == 0) fputs("\033[K", p->destino);
+    p->escritas++;
+  }
+  if (pregunta) {
+    // Lo que quedaba del cuadro anterior desde esta fila hacia abajo ya no
+    // está en pantalla
+    fputs("\033[J", p->destino);
+    Cuadro *a = &p->anterior;
+    while (a->cantidad > 0 && a->lineas[a->cantidad - 1].fila >= p->fila)
+      MEM_FREE(a->lineas[--a->cantidad].texto);
+  }
+  agregar_linea(&p->actual, texto, largo, p->fila, alto, pregunta);
+  p->fila += alto;
+}
+
+static ssize_t escribir_flujo(void *cookie, const char *datos, size_t n) {
+  Pantalla *p = cookie;
+  size_t inicio = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (datos[i] != '\n') continue;
+    if (p->largo_parcial > 0) {
+      // Completa la línea que venía de antes
+      size_t largo = p->largo_parcial + (i - inicio);
+      char *linea = (char *)MEM_MALLOC(largo, MEM_TEXTO);
+      if (linea) {
+        memcpy(linea, p->parcial, p->largo_parcial);
+        memcpy(linea + p->largo_parcial, datos + inicio, i - inicio);
+        escribir_linea(p, linea, largo, 0);
+        MEM_FREE(linea);
+      }
+      p->largo_parcial = 0;
+    } else {
+      escribir_linea(p, datos + inicio, i - inicio, 0);
+    }
+    inicio = i + 1;
+  }
+
+  size_t resto = n - inicio;
+  if (resto > 0) {
+    if (p->largo_parcial + resto > p->capacidad_parcial) {
+      size_t nueva = (p->largo_parcial + resto) * 2;
+      char *parcial = (char *)MEM_REALLOC(p->parcial, nueva, MEM_TEXTO);
+      if (parcial == NULL) return n;
+      p->parcial = parcial;
+      p->capacidad_parcial = nueva;
+    }
+    memcpy(p->parcial + p->largo_parcial, datos + inicio, resto);
+    p->largo_parcial += resto;
+  }
+
+  // Con buffer por línea, una línea a medias sólo se vacía para esperar la
+  // entrada: se muestra como pregunta y el cursor queda al final
+  if (p->largo_parcial > 0) {
+    escribir_linea(p, p->parcial, p->largo_parcial, 1);
+    p->largo_parcial = 0;
+  } else if (!p->de_corrido) {
+    mover(p, p->fila);
+  }
+  fflush(p->destino);
+  return n;
+}
+
+#ifdef __GLIBC__
+Pantalla *pantalla_crear(FILE *destino, int fd) {
+  Pantalla *p = (Pantalla *)MEM_CALLOC(1, sizeof(Pantalla), MEM_TEXTO);
+  if (p == NULL) return NULL;
+  p->destino = destino;
+  p->fd = fd;
+  p->de_corrido = 1; // hasta el primer cuadro no se sabe qué hay en pantalla
+  cookie_io_functions_t funciones = {.write = escribir_flujo};
+  p->flujo = fopencookie(p, "w", funciones);
+  if (p->flujo == NULL) {
+    MEM_FREE(p);
+    return NULL;
+  }
+  setvbuf(p->flujo, NULL, _IOLBF, 16384);
+  medir_terminal(p);
+  return p;
+}
+#else
+// fopencookie es de glibc: sin ella quien llama sigue con stdio común
+Pantalla *pantalla_crear(FILE *destino, int fd) {
+  (void)destino;
+  (void)fd;
+  (void)escribir_flujo;
+  return NULL;
+}
+#endif
+
+FILE *pantalla_flujo(Pantalla *p) { return p->flujo; }
+
+void pantalla_nuevo_cuadro(Pantalla *p) {
+  fflush(p->flujo);
+  int filas = p->filas, columnas = p->columnas;
+  medir_terminal(p);
+
+  Cuadro viejo = p->anterior;
+  p->anterior = p->actual;
+  p->actual = viejo;
+  vaciar_cuadro(&p->actual);
+  if (p->de_corrido || filas != p->filas || columnas != p->columnas) {
+    // No se sabe qué hay en pantalla: se empieza de cero
+    vaciar_cuadro(&p->anterior);
+    fputs("\033[H\033[2J", p->destino);
+    p->de_corrido = 0;
+  }
+  p->siguiente = 0;
+  p->fila = 0;
+  mover(p, 0);
+  fflush(p->destino);
+}
+
+void pantalla_estadisticas(Pantalla *p, long *escritas, long *omitidas) {
+  if (escritas) *escritas = p->escritas;
+  if (omitidas) *omitidas = p->omitidas;
+}
+
+void pantalla_destruir(Pantalla *p) {
+  if (p == NULL) return;
+  vaciar_cuadro(&p->anterior);
+  vaciar_cuadro(&p->actual);
+  MEM_FREE(p->anterior.lineas);
+  MEM_FREE(p->actual.lineas);
+  MEM_FREE(p->parcial);
+  MEM_FREE(p);
+}
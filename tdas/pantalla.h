@@ -0,0 +1,38 @@
+#ifndef PANTALLA_H
+#define PANTALLA_H
+#include <stdio.h>
+
+// Pantalla de terminal dibujada con secuencias ANSI, sin lanzar "clear".
+// Todo lo que se escribe en el FILE de pantalla_flujo pasa por acá: después
+// de pantalla_nuevo_cuadro, cada línea se compara con la que ocupaba la misma
+// fila en el cuadro anterior y sólo se reescriben las que cambiaron.
+//
+// Una línea que se vacía sin su salto es una pregunta: se da por hecho que
+// después se lee la entrada, cuyo eco queda en esa fila (se marca para
+// reescribirla) y baja el cursor a la siguiente. Además se borra lo que
+// quedaba del cuadro anterior por debajo. Si un cuadro no cabe en la
+// terminal, el resto se escribe de corrido y el siguiente empieza limpiando
+// la pantalla completa.
+
+typedef struct Pantalla Pantalla;
+
+// Esta función crea la pantalla, que escribe en destino; fd es la terminal
+// de la que se toma el tamaño. Devuelve NULL si falla o si no hay glibc.
+Pantalla *pantalla_crear(FILE *destino, int fd);
+
+// Esta función devuelve el FILE (con buffer por línea) que hay que usar para
+// escribir en la pantalla, por ejemplo en lugar de stdout.
+FILE *pantalla_flujo(Pantalla *p);
+
+// Esta función empieza un cuadro nuevo arriba de la pantalla (reemplaza a
+// limpiar la pantalla).
+void pantalla_nuevo_cuadro(Pantalla *p);
+
+// Esta función devuelve cuántas líneas se escribieron y cuántas se omitieron
+// por no haber cambiado.
+void pantalla_estadisticas(Pantalla *p, long *escritas, long *omitidas);
+
+// Esta función libera la pantalla. Su FILE debe cerrarse antes.
+void pantalla_destruir(Pantalla *p);
+
+#endif /* PANTALLA_H */
@@ -0,0 +1,291 @@
+#define _GNU_SOURCE
+#include "servidor.h"
+#include "memoria.h"
+#include "traza.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define MAX_EVENTOS 64
+#define TAM_ENTRADA 8192         // una línea no puede ser más larga
+#define TAM_RESPUESTA 512
+#define LINEAS_POR_LOTE 32       // por cliente y vuelta, para repartir el turno
+#define TOPE_SALIDA (1 << 20)    // sobre esto se deja de atender al cliente
+
+typedef struct Cliente {
+  int fd;
+  char entrada[TAM_ENTRADA];
+  size_t usados;                 // bytes en entrada
+  char *salida;                  // respuestas pendientes de enviar
+  size_t enviados, pendientes, capacidad; // salida[enviados..pendientes)
+  unsigned interes;              // eventos registrados en epoll
+  int fin_entrada;               // el cliente ya no va a mandar más
+  int cerrar;                    // cerrar al terminar de enviar
+  struct Cliente *siguiente;
+} Cliente;
+
+struct Servidor {
+  int escucha;
+  int epoll;
+  char *ruta;
+  Cliente *clientes;
+};
+
+static volatile sig_atomic_t detenido = 0;
+
+void servidor_detener() { detenido = 1; }
+
+#ifdef __linux__
+
+Servidor *servidor_crear(const char *ruta) {
+  struct sockaddr_un dir;
+  if (strlen(ruta) >= sizeof(dir.sun_path)) {
+    fprintf(stderr, "La ruta del socket es demasiado larga: %s\n", ruta);
+    return NULL;
+  }
+  memset(&dir, 0, sizeof(dir));
+  dir.sun_family = AF_UNIX;
+  strcpy(dir.sun_path, ruta);
+
+  // Sólo se borra lo que ya era un socket (de una corrida anterior)
+  struct stat st;
+  if (stat(ruta, &st) == 0 && S_ISSOCK(st.st_mode)) unlink(ruta);
+
+  Servidor *s = (Servidor *)MEM_CALLOC(1, sizeof(Servidor), MEM_OTRO);
+  if (s == NULL) return NULL;
+  s->escucha = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  s->epoll = epoll_create1(EPOLL_CLOEXEC);
+  s->ruta = strdup(ruta);
+  if (s->escucha < 0 || s->epoll < 0 || s->ruta == NULL ||
+      bind(s->escucha, (struct sockaddr *)&dir, sizeof(dir)) < 0 ||
+      listen(s->escucha, SOMAXCONN) < 0) {
+    perror("Error al crear el socket del servidor");
+    if (s->escucha >= 0) close(s->escucha);
+    if (s->epoll >= 0) close(s->epoll);
+    free(s->ruta);
+    MEM_FREE(s);
+    return NULL;
+  }
+
+  struct epoll_event ev = {.events = EPOLLIN, .data.ptr = NULL};
+  epoll_ctl(s->epoll, EPOLL_CTL_ADD, s->escucha, &ev);
+  signal(SIGPIPE, SIG_IGN); // un cliente que se fue no debe matar al servidor
+  detenido = 0;
+  return s;
+}
+
+static void cerrar_cliente(Servidor *s, Cliente *c) {
+  Cliente **p = &s->clientes;
+  while (*p != c) p = &(*p)->siguiente;
+  *p = c->siguiente;
+  close(c->fd); // también lo saca de epoll
+  MEM_FREE(c->salida);
+  MEM_FREE(c);
+}
+
+static void aceptar(Servidor *s) {
+  for (;;) {
+    int fd = accept4(s->escucha, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return; // EAGAIN: no quedan conexiones pendientes
+    Cliente *c = (Cliente *)MEM_CALLOC(1, sizeof(Cliente), MEM_OTRO);
+    if (c == NULL) {
+      close(fd);
+      continue;
+    }
+    c->fd = fd;
+    c->interes = EPOLLIN;
+    struct epoll_event ev = {.events = c->interes, .data.ptr = c};
+    epoll_ctl(s->epoll, EPOLL_CTL_ADD, fd, &ev);
+    c->siguiente = s->clientes;
+    s->clientes = c;
+  }
+}
+
+// Lee lo que haya sin bloquear. Si el otro extremo terminó de enviar, lo
+// que ya mandó se atiende igual y el cliente se cierra después.
+static void leer(Cliente *c) {
+  while (c->usados < TAM_ENTRADA && !c->fin_entrada) {
+    ssize_t n = read(c->fd, c->entrada + c->usados, TAM_ENTRADA - c->usados);
+    if (n > 0) {
+      c->usados += n;
+    } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+      c->fin_entrada = 1;
+    } else if (errno == EAGAIN) {
+      return;
+    }
+  }
+}
+
+static void encolar(Cliente *c, const char *texto, size_t n) {
+  if (c->pendientes + n > c->capacidad) {
+    // Primero se compacta lo ya enviado; si no alcanza, se agranda
+    if (c->enviados > 0) {
+      memmove(c->salida, c->salida + c->enviados, c->pendientes - c->enviados);
+      c->pendientes -= c->enviados;
+      c->enviados = 0;
+    }
+    if (c->pendientes + n > c->capacidad) {
+      size_t nueva = c->capacidad ? c->capacidad : 4096;
+      while (nueva < c->pendientes + n) nueva *= 2;
+      char *salida = (char *)MEM_REALLOC(c->salida, nueva, MEM_OTRO);
+      if (salida == NULL) return;
+      c->salida = salida;
+      c->capacidad = nueva;
+    }
+  }
+  memcpy(c->salida + c->pendientes, texto, n);
+  c->pendientes += n;
+}
+
+static void escribir(Cliente *c) {
+  while (c->enviados < c->pendientes) {
+    ssize_t n = write(c->fd, c->salida + c->enviados, c->pendientes - c->enviados);
+    if (n > 0) {
+      c->enviados += n;
+    } else {
+      if (errno == EINTR) continue;
+      if (errno != EAGAIN) {
+        // El cliente se fue: lo que quedaba ya no se puede entregar
+        c->cerrar = 1;
+        c->enviados = c->pendientes;
+      }
+      return;
+    }
+  }
+  c->enviados = c->pendientes = 0;
+}
+
+// Atiende hasta LINEAS_POR_LOTE líneas completas del cliente y suma las que
+// atendió; devuelve 1 si le quedaron líneas para la vuelta siguiente
+static int atender_cliente(Cliente *c, AtenderLinea atender, void *datos,
+                           int *total) {
+  char respuesta[TAM_RESPUESTA];
+  size_t inicio = 0;
+  int atendidas = 0;
+  while (atendidas < LINEAS_POR_LOTE && !c->cerrar &&
+         c->pendientes - c->enviados < TOPE_SALIDA) {
+    char *fin = memchr(c->entrada + inicio, '\n', c->usados - inicio);
+    if (fin == NULL) break;
+    *fin = '\0';
+    int r = atender(c->entrada + inicio, respuesta, sizeof(respuesta), datos);
+    inicio = fin - c->entrada + 1;
+    atendidas++;
+    if (r != SERVIDOR_SIN_RESPUESTA) {
+      size_t n = strlen(respuesta);
+      respuesta[n] = '\n';
+      encolar(c, respuesta, n + 1);
+    }
+    if (r == SERVIDOR_CERRAR) c->cerrar = 1;
+  }
+  memmove(c->entrada, c->entrada + inicio, c->usados - inicio);
+  c->usados -= inicio;
+  *total += atendidas;
+
+  if (c->usados == TAM_ENTRADA && !memchr(c->entrada, '\n', c->usados)) {
+    static const char error[] = "error linea demasiado larga\n";
+    encolar(c, error, sizeof(error) - 1);
+    c->usados = 0;
+  }
+  int quedan = !c->cerrar && memchr(c->entrada, '\n', c->usados) != NULL;
+  if (c->fin_entrada && !quedan) c->cerrar = 1; // una línea sin \n final se descarta
+  // Un cliente atrasado en leer sus respuestas espera a EPOLLOUT
+  return quedan && c->pendientes - c->enviados < TOPE_SALIDA;
+}
+
+// Se escucha la entrada sólo si hay lugar para leer y el cliente no está
+// atrasado en recibir sus respuestas, y la salida sólo si hay algo pendiente
+static void actualizar_interes(Servidor *s, Cliente *c) {
+  unsigned interes = 0;
+  if (!c->cerrar && !c->fin_entrada && c->usados < TAM_ENTRADA &&
+      c->pendientes - c->enviados < TOPE_SALIDA)
+    interes |= EPOLLIN;
+  if (c->pendientes > c->enviados) interes |= EPOLLOUT;
+  if (interes == c->interes) return;
+  struct epoll_event ev = {.events = interes, .data.ptr = c};
+  epoll_ctl(s->epoll, EPOLL_CTL_MOD, c->fd, &ev);
+  c->interes = interes;
+}
+
+int servidor_ejecutar(Servidor *s, AtenderLinea atender, FinLote fin_lote,
+                      void *datos) {
+  struct epoll_event eventos[MAX_EVENTOS];
+  int quedan_lineas = 0;
+
+  while (!detenido) {
+    // Si algún cliente quedó con líneas por atender no se espera
+    int n = epoll_wait(s->epoll, eventos, MAX_EVENTOS, quedan_lineas ? 0 : -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      perror("epoll_wait");
+      return -1;
+    }
+    for (int i = 0; i < n; i++) {
+      Cliente *c = eventos[i].data.ptr;
+      if (c == NULL) {
+        aceptar(s);
+        continue;
+      }
+      if (eventos[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) leer(c);
+      if (eventos[i].events & EPOLLOUT) escribir(c);
+    }
+
+    // Lote: las líneas completas de todos los clientes, en el mismo hilo
+    TRAZA_INICIO(lote);
+    quedan_lineas = 0;
+    int atendidas = 0;
+    for (Cliente *c = s->clientes; c != NULL; c = c->siguiente)
+      quedan_lineas |= atender_cliente(c, atender, datos, &atendidas);
+    if (fin_lote && atendidas > 0) fin_lote(datos);
+    TRAZA_FIN(lote, "lote_comandos", "servidor");
+
+    Cliente *c = s->clientes;
+    while (c != NULL) {
+      Cliente *siguiente = c->siguiente;
+      escribir(c);
+      if (c->cerrar && c->pendientes == c->enviados) cerrar_cliente(s, c);
+      else actualizar_interes(s, c);
+      c = siguiente;
+    }
+  }
+  return 0;
+}
+
+void servidor_destruir(Servidor *s) {
+  if (s == NULL) return;
+  while (s->clientes) {
+    escribir(s->clientes); // lo que se pueda enviar sin bloquear
+    cerrar_cliente(s, s->clientes);
+  }
+  close(s->escucha);
+  close(s->epoll);
+  unlink(s->ruta);
+  free(s->ruta);
+  MEM_FREE(s);
+}
+#else
+// epoll y accept4 son de Linux: en otros sistemas no hay modo servidor
+Servidor *servidor_crear(const char *ruta) {
+  (void)ruta;
+  return NULL;
+}
+
+int servidor_ejecutar(Servidor *s, AtenderLinea atender, FinLote fin_lote,
+                      void *datos) {
+  (void)s;
+  (void)atender;
+  (void)fin_lote;
+  (void)datos;
+  return -1;
+}
+
+void servidor_destruir(Servidor *s) { (void)s; }
+#endif
@@ -0,0 +1,45 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+#include <stddef.h>
+
+// Servidor de líneas sobre un socket Unix con un único ciclo de eventos
+// (epoll). Varios clientes se conectan a la vez; en cada vuelta del ciclo se
+// leen los datos de todos los clientes listos y sus líneas completas se
+// atienden en un solo lote, en el hilo del ciclo, así que el estado que toca
+// la función de atención no necesita locks. Las respuestas se encolan por
+// cliente y se envían sin bloquear: un cliente lento no frena a los demás.
+
+typedef struct Servidor Servidor;
+
+// Lo que devuelve la función de atención de cada línea
+#define SERVIDOR_RESPONDER  0 // enviar la respuesta
+#define SERVIDOR_CERRAR     1 // enviar la respuesta y cerrar ese cliente
+#define SERVIDOR_SIN_RESPUESTA 2
+
+// Atiende una línea (sin el salto) y escribe la respuesta, también sin salto,
+// en respuesta (de tam bytes). Puede modificar la línea.
+typedef int (*AtenderLinea)(char *linea, char *respuesta, size_t tam,
+                            void *datos);
+
+// Se llama en el hilo del ciclo después de cada lote que atendió al menos
+// una línea, antes de enviar las respuestas.
+typedef void (*FinLote)(void *datos);
+
+// Esta función crea el socket en ruta y lo deja escuchando. Si en ruta queda
+// un socket de una corrida anterior lo reemplaza. Devuelve NULL si falla
+// (fuera de Linux, siempre).
+Servidor *servidor_crear(const char *ruta);
+
+// Esta función atiende clientes hasta que se llame a servidor_detener.
+// fin_lote puede ser NULL. Devuelve 0 si terminó bien y -1 si falló epoll.
+int servidor_ejecutar(Servidor *s, AtenderLinea atender, FinLote fin_lote,
+                      void *datos);
+
+// Esta función pide que servidor_ejecutar termine al final de la vuelta
+// actual. Se puede llamar desde un manejador de señales.
+void servidor_detener();
+
+// Esta función cierra las conexiones y el socket, y borra su archivo.
+void servidor_destruir(Servidor *s);
+
+#endif /* SERVIDOR_H */
@@ -0,0 +1,118 @@
+#include "texto.h"
+#include "memoria.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct Texto {
+  char *datos;
+  size_t largo;
+  size_t capacidad;
+};
+
+// "00" "01" ... "99": se escriben dos dígitos por división
+static const char pares[] = "00010203040506070809"
+                            "10111213141516171819"
+                            "20212223242526272829"
+                            "30313233343536373839"
+                            "40414243444546474849"
+                            "50515253545556575859"
+                            "60616263646566676869"
+                            "70717273747576777879"
+                            "80818283848586878889"
+                            "90919293949596979899";
+
+Texto *texto_crear(size_t capacidad) {
+  Texto *t = (Texto *)MEM_MALLOC(sizeof(Texto), MEM_TEXTO);
+  if (t == NULL) return NULL;
+  t->capacidad = capacidad > 64 ? capacidad : 64;
+  t->datos = (char *)MEM_MALLOC(t->capacidad, MEM_TEXTO);
+  t->largo = 0;
+  if (t->datos == NULL) {
+    MEM_FREE(t);
+    return NULL;
+  }
+  return t;
+}
+
+// Deja lugar para n bytes más; si no hay memoria devuelve 0 y el texto se
+// trunca
+static int reservar(Texto *t, size_t n) {
+  if (t->largo + n <= t->capacidad) return 1;
+  size_t nueva = t->capacidad * 2;
+  while (nueva < t->largo + n) nueva *= 2;
+  char *datos = (char *)MEM_REALLOC(t->datos, nueva, MEM_TEXTO);
+  if (datos == NULL) return 0;
+  t->datos = datos;
+  t->capacidad = nueva;
+  return 1;
+}
+
+void texto_bytes(Texto *t, const char *datos, size_t n) {
+  if (!reservar(t, n)) return;
+  memcpy(t->datos + t->largo, datos, n);
+  t->largo += n;
+}
+
+void texto_cadena(Texto *t, const char *cadena) {
+  texto_bytes(t, cadena, strlen(cadena));
+}
+
+void texto_caracter(Texto *t, char c) {
+  if (!reservar(t, 1)) return;
+  t->datos[t->largo++] = c;
+}
+
+// Escribe los dígitos de derecha a izquierda al final de digitos (de 24
+// bytes) y devuelve dónde empiezan
+static char *formatear(long valor, char *digitos) {
+  char *p = digitos + 24;
+  unsigned long u = valor < 0 ? 0ul - (unsigned long)valor : (unsigned long)valor;
+  while (u >= 100) {
+    p -= 2;
+    memcpy(p, pares + (u % 100) * 2, 2);
+    u /= 100;
+  }
+  if (u >= 10) {
+    p -= 2;
+    memcpy(p, pares + u * 2, 2);
+  } else {
+    *--p = (char)('0' + u);
+  }
+  if (valor < 0) *--p = '-';
+  return p;
+}
+
+void texto_entero(Texto *t, long valor) {
+  char digitos[24];
+  char *inicio = formatear(valor, digitos);
+  texto_bytes(t, inicio, digitos + 24 - inicio);
+}
+
+void texto_entero_ancho(Texto *t, long valor, int ancho) {
+  char digitos[24];
+  char *inicio = formatear(valor, digitos);
+  int n = (int)(digitos + 24 - inicio);
+  for (int i = n; i < ancho; i++) texto_caracter(t, ' ');
+  texto_bytes(t, inicio, n);
+}
+
+void texto_cadena_ancho(Texto *t, const char *cadena, int ancho) {
+  size_t n = strlen(cadena);
+  texto_bytes(t, cadena, n);
+  for (int i = (int)n; i < ancho; i++) texto_caracter(t, ' ');
+}
+
+size_t texto_largo(Texto *t) { return t->largo; }
+
+void texto_volcar(Texto *t, FILE *salida) {
+  if (t->largo > 0) fwrite(t->datos, 1, t->largo, salida);
+  t->largo = 0;
+}
+
+void texto_vaciar(Texto *t) { t->largo = 0; }
+
+void texto_destruir(Texto *t) {
+  if (t == NULL) return;
+  MEM_FREE(t->datos);
+  MEM_FREE(t);
+}
@@ -0,0 +1,44 @@
+#ifndef TEXTO_H
+#define TEXTO_H
+#include <stddef.h>
+#include <stdio.h>
+
+// Buffer de texto reutilizable para armar una pantalla completa y escribirla
+// de una sola vez. Los enteros se formatean a mano (sin printf) y el buffer
+// crece duplicándose; al volcarlo queda vacío pero conserva su memoria.
+
+typedef struct Texto Texto;
+
+// Esta función crea un buffer vacío con lugar para capacidad bytes.
+Texto *texto_crear(size_t capacidad);
+
+// Esta función agrega la cadena al final del buffer.
+void texto_cadena(Texto *t, const char *cadena);
+
+// Esta función agrega n bytes al final del buffer.
+void texto_bytes(Texto *t, const char *datos, size_t n);
+
+void texto_caracter(Texto *t, char c);
+
+// Esta función agrega el entero en decimal.
+void texto_entero(Texto *t, long valor);
+
+// Esta función agrega el entero alineado a la derecha en ancho caracteres
+// (como "%*ld").
+void texto_entero_ancho(Texto *t, long valor, int ancho);
+
+// Esta función agrega la cadena completando con espacios hasta ancho
+// caracteres (como "%-*s").
+void texto_cadena_ancho(Texto *t, const char *cadena, int ancho);
+
+size_t texto_largo(Texto *t);
+
+// Esta función escribe el contenido en salida con un solo fwrite y deja el
+// buffer vacío.
+void texto_volcar(Texto *t, FILE *salida);
+
+void texto_vaciar(Texto *t);
+
+void texto_destruir(Texto *t);
+
+#endif /* TEXTO_H */
@@ -0,0 +1,153 @@
+#include "traza.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CAPACIDAD_ANILLO 16384 // eventos por hilo (potencia de 2)
+
+typedef struct {
+  const char *nombre;
+  const char *categoria;
+  uint64_t inicio;   // ns
+  uint64_t duracion; // ns; UINT64_MAX para eventos instantáneos
+} EventoTraza;
+
+// Un anillo por hilo: sólo su hilo escribe (y avanza escritos) y sólo quien
+// vuelca lee (y avanza leidos)
+typedef struct Anillo {
+  EventoTraza eventos[CAPACIDAD_ANILLO];
+  _Atomic uint64_t escritos;
+  uint64_t leidos;
+  int tid;
+  const char *nombre_hilo;
+  struct Anillo *siguiente;
+} Anillo;
+
+_Atomic int traza_activa = 0;
+
+static _Atomic(Anillo *) anillos = NULL;
+static atomic_int siguiente_tid = 1;
+static _Thread_local Anillo *anillo_local = NULL;
+static FILE *salida = NULL;
+static uint64_t origen = 0;
+static long perdidos = 0;
+
+uint64_t traza_ahora_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// Anillo del hilo actual; se crea y se publica en la lista la primera vez
+static Anillo *anillo_hilo() {
+  if (anillo_local) return anillo_local;
+  Anillo *a = (Anillo *)calloc(1, sizeof(Anillo));
+  if (a == NULL) return NULL;
+  a->tid = atomic_fetch_add(&siguiente_tid, 1);
+  Anillo *cabeza = atomic_load(&anillos);
+  do {
+    a->siguiente = cabeza;
+  } while (!atomic_compare_exchange_weak(&anillos, &cabeza, a));
+  anillo_local = a;
+  return a;
+}
+
+static void agregar(const char *nombre, const char *categoria, uint64_t inicio,
+                    uint64_t duracion) {
+  Anillo *a = anillo_hilo();
+  if (a == NULL) return;
+  uint64_t n = atomic_load_explicit(&a->escritos, memory_order_relaxed);
+  // Quien vuelca debe ver el contador anterior antes que los campos pisados
+  atomic_thread_fence(memory_order_release);
+  EventoTraza *e = &a->eventos[n & (CAPACIDAD_ANILLO - 1)];
+  e->nombre = nombre;
+  e->categoria = categoria;
+  e->inicio = inicio;
+  e->duracion = duracion;
+  atomic_store_explicit(&a->escritos, n + 1, memory_order_release);
+}
+
+void traza_registrar(const char *nombre, const char *categoria, uint64_t inicio) {
+  if (!traza_activa) return;
+  agregar(nombre, categoria, inicio, traza_ahora_ns() - inicio);
+}
+
+void traza_marca(const char *nombre, const char *categoria) {
+  if (!traza_activa) return;
+  agregar(nombre, categoria, traza_ahora_ns(), UINT64_MAX);
+}
+
+void traza_nombrar_hilo(const char *nombre) {
+  Anillo *a = anillo_hilo();
+  if (a) a->nombre_hilo = nombre;
+}
+
+int traza_iniciar(const char *ruta) {
+  salida = fopen(ruta, "w");
+  if (salida == NULL) return 0;
+  origen = traza_ahora_ns();
+  fprintf(salida, "[\n");
+  traza_activa = 1;
+  return 1;
+}
+
+static void escribir_evento(int tid, EventoTraza *e) {
+  double ts = (e->inicio - origen) / 1000.0; // microsegundos
+  if (e->duracion == UINT64_MAX) {
+    fprintf(salida,
+            "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"g\","
+            "\"ts\":%.3f,\"pid\":1,\"tid\":%d},\n",
+            e->nombre, e->categoria, ts, tid);
+  } else {
+    fprintf(salida,
+            "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,"
+            "\"dur\":%.3f,\"pid\":1,\"tid\":%d},\n",
+            e->nombre, e->categoria, ts, e->duracion / 1000.0, tid);
+  }
+}
+
+void traza_volcar() {
+  if (salida == NULL) return;
+  for (Anillo *a = atomic_load(&anillos); a != NULL; a = a->siguiente) {
+    uint64_t hasta = atomic_load_explicit(&a->escritos, memory_order_acquire);
+    uint64_t desde = a->leidos;
+    if (hasta - desde > CAPACIDAD_ANILLO) {
+      perdidos += (long)(hasta - desde - CAPACIDAD_ANILLO);
+      desde = hasta - CAPACIDAD_ANILLO;
+    }
+    for (uint64_t i = desde; i < hasta; i++) {
+      EventoTraza copia = a->eventos[i & (CAPACIDAD_ANILLO - 1)];
+      // Si el hilo empezó a reescribir esa posición mientras se copiaba, se
+      // descarta. La barrera impide que la copia se lea después del contador.
+      atomic_thread_fence(memory_order_acquire);
+      uint64_t ahora = atomic_load_explicit(&a->escritos, memory_order_relaxed);
+      if (ahora - i >= CAPACIDAD_ANILLO) {
+        perdidos++;
+        continue;
+      }
+      escribir_evento(a->tid, &copia);
+    }
+    a->leidos = hasta;
+  }
+  fflush(salida);
+}
+
+void traza_terminar() {
+  if (salida == NULL) return;
+  traza_volcar();
+  traza_activa = 0;
+  for (Anillo *a = atomic_load(&anillos); a != NULL; a = a->siguiente) {
+    if (a->nombre_hilo)
+      fprintf(salida,
+              "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+              "\"args\":{\"name\":\"%s\"}},\n",
+              a->tid, a->nombre_hilo);
+  }
+  fprintf(salida,
+          "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+          "\"args\":{\"name\":\"gestor_hospital\",\"eventos_perdidos\":%ld}}\n]\n",
+          perdidos);
+  fclose(salida);
+  salida = NULL;
+}
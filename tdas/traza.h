@@ -0,0 +1,45 @@
+#ifndef TRAZA_H
+#define TRAZA_H
+#include <stdint.h>
+
+// Trazas de fases en el formato de eventos de Chrome (se abren en
+// chrome://tracing o en Perfetto). Cada hilo guarda sus eventos en un anillo
+// propio: registrar un evento no toma locks ni pide memoria (salvo la
+// primera vez en cada hilo). traza_volcar pasa al archivo lo acumulado.
+//
+// Con la traza desactivada, TRAZA_INICIO y TRAZA_FIN sólo leen una variable
+// global (atómica, porque otros hilos la leen mientras el principal la cambia).
+
+extern _Atomic int traza_activa;
+
+#define TRAZA_INICIO(var) uint64_t var = traza_activa ? traza_ahora_ns() : 0
+#define TRAZA_FIN(var, nombre, categoria)                                      \
+  do {                                                                         \
+    if (var) traza_registrar((nombre), (categoria), (var));                    \
+  } while (0)
+
+// Esta función abre el archivo de la traza y la activa. Devuelve 0 si no pudo
+// abrirlo.
+int traza_iniciar(const char *ruta);
+
+// Esta función escribe los eventos pendientes de todos los hilos. Debe
+// llamarla un solo hilo a la vez.
+void traza_volcar();
+
+// Esta función vuelca lo pendiente, cierra el archivo y desactiva la traza.
+void traza_terminar();
+
+uint64_t traza_ahora_ns();
+
+// Esta función registra un tramo que empezó en inicio y termina ahora. nombre
+// y categoria deben ser cadenas que vivan hasta el volcado (por ejemplo
+// literales).
+void traza_registrar(const char *nombre, const char *categoria, uint64_t inicio);
+
+// Esta función registra un evento instantáneo (por ejemplo, el cambio de día).
+void traza_marca(const char *nombre, const char *categoria);
+
+// Esta función da nombre al hilo actual en la línea de tiempo.
+void traza_nombrar_hilo(const char *nombre);
+
+#endif /* TRAZA_H */
@@ -0,0 +1,135 @@
+#include "trie.h"
+#include "hashmap.h"
+#include "memoria.h"
+#include "traza.h"
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Los hijos de un nodo forman una lista enlazada (primer hijo / siguiente
+// hermano): ocupa poco por nodo y el alfabeto de los nombres es chico.
+typedef struct TrieNode {
+  unsigned char c;
+  struct TrieNode *hijo;
+  struct TrieNode *hermano;
+  HashMap *valores; // valor -> valor; NULL si ninguna clave termina aquí
+} TrieNode;
+
+struct Trie {
+  TrieNode raiz;
+  int size;
+};
+
+typedef Trie Trie;
+
+// Los valores se identifican por su dirección
+static unsigned hash_puntero(void *key) {
+  uintptr_t h = (uintptr_t)key;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return (unsigned)h;
+}
+
+static int is_equal_puntero(void *key1, void *key2) { return key1 == key2; }
+
+Trie *trie_create() {
+  Trie *T = (Trie *)MEM_CALLOC(1, sizeof(Trie), MEM_TRIE);
+  return T;
+}
+
+// Devuelve el hijo de n con el carácter c, creándolo si crear es 1
+static TrieNode *hijo(TrieNode *n, unsigned char c, int crear) {
+  for (TrieNode *h = n->hijo; h != NULL; h = h->hermano) {
+    if (h->c == c) return h;
+  }
+  if (!crear) return NULL;
+  TrieNode *nuevo = (TrieNode *)MEM_CALLOC(1, sizeof(TrieNode), MEM_TRIE);
+  if (nuevo == NULL) return NULL;
+  nuevo->c = c;
+  nuevo->hermano = n->hijo;
+  n->hijo = nuevo;
+  return nuevo;
+}
+
+static TrieNode *bajar(Trie *T, const char *key, int crear) {
+  TrieNode *n = &T->raiz;
+  for (const unsigned char *k = (const unsigned char *)key; *k && n; k++) {
+    n = hijo(n, (unsigned char)tolower(*k), crear);
+  }
+  return n;
+}
+
+void trie_insert(Trie *T, const char *key, void *value) {
+  if (T == NULL || key == NULL || *key == '\0') return;
+  TrieNode *n = bajar(T, key, 1);
+  if (n == NULL) return;
+  if (n->valores == NULL) {
+    n->valores = hashmap_create(hash_puntero, is_equal_puntero);
+    if (n->valores == NULL) return;
+  }
+  if (hashmap_search(n->valores, value) != NULL) return;
+  hashmap_insert(n->valores, value, value);
+  T->size++;
+}
+
+// Quita el valor de la clave que sigue desde n y, al volver, poda los hijos
+// que quedaron sin valores ni hijos. Devuelve 1 si el valor estaba.
+static int quitar(TrieNode *n, const unsigned char *k, void *value) {
+  if (*k == '\0') {
+    if (n->valores == NULL) return 0;
+    MapPair *pair = hashmap_remove(n->valores, value);
+    if (pair == NULL) return 0;
+    MEM_FREE(pair);
+    if (hashmap_size(n->valores) == 0) {
+      hashmap_destroy(n->valores);
+      n->valores = NULL;
+    }
+    return 1;
+  }
+  TrieNode **enlace = &n->hijo;
+  unsigned char c = (unsigned char)tolower(*k);
+  while (*enlace != NULL && (*enlace)->c != c) enlace = &(*enlace)->hermano;
+  TrieNode *h = *enlace;
+  if (h == NULL || !quitar(h, k + 1, value)) return 0;
+  if (h->hijo == NULL && h->valores == NULL) {
+    *enlace = h->hermano;
+    MEM_FREE(h);
+  }
+  return 1;
+}
+
+void trie_remove(Trie *T, const char *key, void *value) {
+  if (T == NULL || key == NULL) return;
+  if (quitar(&T->raiz, (const unsigned char *)key, value)) T->size--;
+}
+
+// Recorrido en profundidad del subárbol; devuelve cuántos valores agregó
+static int recolectar(TrieNode *n, ArrayList *out, int max) {
+  int agregados = 0;
+  if (n->valores != NULL) {
+    for (MapPair *pair = hashmap_first(n->valores); pair != NULL;
+         pair = hashmap_next(n->valores)) {
+      if (max >= 0 && agregados >= max) return agregados;
+      arraylist_pushBack(out, pair->value);
+      agregados++;
+    }
+  }
+  for (TrieNode *h = n->hijo; h != NULL; h = h->hermano) {
+    if (max >= 0 && agregados >= max) break;
+    agregados += recolectar(h, out, max < 0 ? -1 : max - agregados);
+  }
+  return agregados;
+}
+
+int trie_search_prefix(Trie *T, const char *prefix, ArrayList *out, int max) {
+  if (T == NULL || prefix == NULL || out == NULL) return 0;
+  TRAZA_INICIO(inicio);
+  TrieNode *n = bajar(T, prefix, 0);
+  int agregados = n ? recolectar(n, out, max) : 0;
+  TRAZA_FIN(inicio, "trie_search_prefix", "tda");
+  return agregados;
+}
+
+int trie_size(Trie *T) { return T ? T->size : 0; }
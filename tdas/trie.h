@@ -0,0 +1,31 @@
+#ifndef TRIE_H
+#define TRIE_H
+#include "arraylist.h"
+
+// Árbol de prefijos sobre cadenas, sin distinguir mayúsculas de minúsculas.
+// Cada clave puede tener varios valores asociados (por ejemplo, todos los
+// pacientes que se llaman igual); buscar un prefijo cuesta O(largo del
+// prefijo) más la cantidad de valores encontrados.
+
+typedef struct Trie Trie;
+
+// Esta función crea un trie vacío y devuelve un puntero a él.
+Trie *trie_create();
+
+// Esta función asocia el valor a la clave. Un mismo valor no se repite bajo
+// la misma clave.
+void trie_insert(Trie *T, const char *key, void *value);
+
+// Esta función quita el valor de la clave (si estaba asociado a ella).
+void trie_remove(Trie *T, const char *key, void *value);
+
+// Esta función agrega a out los valores de todas las claves que comienzan
+// con el prefijo, hasta un máximo de max valores (max < 0: sin máximo), y
+// devuelve cuántos agregó. Un valor asociado a varias claves puede aparecer
+// más de una vez.
+int trie_search_prefix(Trie *T, const char *prefix, ArrayList *out, int max);
+
+// Esta función devuelve la cantidad de pares (clave, valor) del trie.
+int trie_size(Trie *T);
+
+#endif /* TRIE_H */